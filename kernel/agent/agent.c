@@ -3,6 +3,20 @@
 
 #include "agent.h"
 #include "audit/audit.h"
+#include "cap/cap.h"
+#include "channel/channel.h"
+#include "shm/shm.h"
+#include "trace/trace.h"
+#include "prof/bootprof.h"
+#include "timer/sleep.h"
+#include "timer/timer.h"
+#include "clock/clock.h"
+#include "snapshot/snapshot.h"
+#include "tunable/tunable.h"
+#include "arch/x86_64/paging.h"
+#include "arch/x86_64/usermode.h"
+#include "lib/string.h"
+#include "lib/format.h"
 
 // Fixed-size agent table
 static agent_t agent_table[AGENT_MAX_COUNT];
@@ -13,63 +27,97 @@ static unsigned int agent_count_value = 0;
 // Initialization flag
 static int agent_initialized = 0;
 
-// Helper function to copy string (no libc)
-static void str_copy(char* dest, const char* src, unsigned int max_len) {
-    unsigned int i = 0;
-    while (src[i] != '\0' && i < max_len - 1) {
-        dest[i] = src[i];
-        i++;
-    }
-    dest[i] = '\0';
+// Per-boot tunables, read once in agent_init(): usable slots and the
+// default CPU budget in cycles
+static unsigned int agent_slot_limit = AGENT_MAX_COUNT;
+static unsigned long long agent_default_budget = 0;
+
+// Agent currently running in ring 3 (-1 while the kernel runs)
+static int agent_current_id = -1;
+
+// CPU accounting for the running agent: TSC and idle total at entry, so
+// its CPU time is wall time minus time halted (sleeps, input waits)
+static unsigned long long agent_run_start = 0;
+static unsigned long long agent_idle_start = 0;
+
+// Set by the tick when the agent went over budget inside a system call
+static volatile int agent_budget_pending = 0;
+
+// Record a change to an agent's slot for the next checkpoint
+static inline void agent_dirty(int id) {
+    snapshot_dirty(SNAPSHOT_SECTION_AGENTS, &agent_table[id], sizeof(agent_table[id]));
 }
 
-// Helper function to get string length (no libc)
-static unsigned int str_len(const char* s) {
-    unsigned int len = 0;
-    while (s[len] != '\0') {
-        len++;
+// Snapshot restored: recount the slots, and complete any agent that was
+// mid-run when the checkpoint was taken (its ring-3 state is gone)
+static void agent_restored(void) {
+    agent_count_value = 0;
+    for (unsigned int i = 0; i < AGENT_MAX_COUNT; i++) {
+        if (agent_table[i].state == AGENT_STATE_RUNNING) {
+            agent_table[i].state = AGENT_STATE_COMPLETED;
+        }
+        if (agent_table[i].state != AGENT_STATE_INVALID) {
+            agent_count_value++;
+        }
     }
-    return len;
 }
 
-// Helper function to build audit message: "agent_name suffix"
-static void build_audit_msg(char* msg, const char* agent_name, const char* suffix, unsigned int max_len) {
-    unsigned int pos = 0;
-    
-    // Copy agent name
-    unsigned int name_len = str_len(agent_name);
-    for (unsigned int i = 0; i < name_len && pos < max_len - 1; i++) {
-        msg[pos++] = agent_name[i];
+// CPU cycles used so far by the running agent
+static unsigned long long agent_cpu_now(void) {
+    return (clock_cycles() - agent_run_start) - (timer_idle_cycles() - agent_idle_start);
+}
+
+// Stop the running agent for exceeding its budget (audited); does not return
+static void agent_budget_stop(void) {
+    agent_t* agent = &agent_table[agent_current_id];
+    char audit_msg[128];
+    ksnprintf(audit_msg, sizeof(audit_msg), "%s agent exceeded CPU budget (%u ms)", agent->name,
+              (unsigned int)clock_div64(agent->budget_cycles, clock_cycles_per_ms()));
+    agent_budget_pending = 0;
+    audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, agent_current_id, -1, audit_msg);
+    usermode_exit(USERMODE_EXIT_BUDGET);
+}
+
+// Timer tick: enforce the running agent's budget
+static void agent_budget_tick(interrupt_frame_t* frame) {
+    if (agent_current_id < 0) {
+        return;
     }
-    
-    // Append space if there's room
-    if (pos < max_len - 1) {
-        msg[pos++] = ' ';
+    agent_t* agent = &agent_table[agent_current_id];
+    if (agent->budget_cycles == 0 || agent_cpu_now() <= agent->budget_cycles) {
+        return;
     }
     
-    // Append suffix
-    unsigned int suffix_len = str_len(suffix);
-    for (unsigned int i = 0; i < suffix_len && pos < max_len - 1; i++) {
-        msg[pos++] = suffix[i];
+    // Kernel state is only consistent at the ring-3 boundary: stop a user
+    // loop right here, a system call on its way out
+    if (INTERRUPT_FRAME_FROM_USER(frame)) {
+        agent_budget_stop();
     }
-    
-    msg[pos] = '\0';
+    agent_budget_pending = 1;
 }
 
 void agent_init(void) {
-    // Initialize all agent slots to invalid state
-    for (unsigned int i = 0; i < AGENT_MAX_COUNT; i++) {
-        agent_table[i].name[0] = '\0';
-        agent_table[i].entry = 0;
-        agent_table[i].context = 0;
-        agent_table[i].state = AGENT_STATE_INVALID;
-    }
-    
-    agent_count_value = 0;
+    // The table starts zeroed in BSS: every slot is already AGENT_STATE_INVALID
+    unsigned int budget_ms = tunable_get(TUNABLE_BUDGET_MS);
+    agent_slot_limit = tunable_get(TUNABLE_AGENTS);
+    agent_default_budget = (unsigned long long)budget_ms * clock_cycles_per_ms();
     agent_initialized = 1;
+    
+    // Restored agents must fit agents= and carry this boot's budget_ms=, so
+    // a snapshot taken under other values is not restored
+    snapshot_register(SNAPSHOT_SECTION_AGENTS, agent_table, sizeof(agent_table), agent_restored);
+    snapshot_config(SNAPSHOT_SECTION_AGENTS, &agent_slot_limit, sizeof(agent_slot_limit));
+    snapshot_config(SNAPSHOT_SECTION_AGENTS, &budget_ms, sizeof(budget_ms));
+    
+    if (timer_register_tick(agent_budget_tick) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register agent budget tick");
+    }
 }
 
-int agent_create(const char* name, agent_entry_t entry, void* context) {
+// Claim the first free slot and fill in its fields; the caller sets up the
+// address space and audits the creation
+// Returns: agent ID, or -1 on failure (not initialized, invalid args or table full)
+static int agent_slot_alloc(const char* name, agent_entry_t entry, void* context) {
     // Check if initialized
     if (!agent_initialized) {
         return -1;
@@ -81,36 +129,35 @@ int agent_create(const char* name, agent_entry_t entry, void* context) {
     }
     
     // Check name length (must fit in buffer, leave room for null terminator)
-    if (str_len(name) >= AGENT_NAME_MAX) {
+    if (strnlen(name, AGENT_NAME_MAX) >= AGENT_NAME_MAX) {
         return -1;
     }
     
-    // Check if table is full
-    if (agent_count_value >= AGENT_MAX_COUNT) {
+    // Check if table is full (agents= may leave the last slots unused)
+    if (agent_count_value >= agent_slot_limit) {
         return -1;
     }
     
     // Find first available slot
-    for (unsigned int i = 0; i < AGENT_MAX_COUNT; i++) {
+    for (unsigned int i = 0; i < agent_slot_limit; i++) {
         if (agent_table[i].state == AGENT_STATE_INVALID) {
             // Copy name
-            str_copy(agent_table[i].name, name, AGENT_NAME_MAX);
-            
+            strlcpy(agent_table[i].name, name, AGENT_NAME_MAX);
+    
             // Set entry point and context
             agent_table[i].entry = entry;
+            agent_table[i].prepare = 0;
             agent_table[i].context = context;
-            
+            agent_table[i].cpu_cycles = 0;
+            agent_table[i].budget_cycles = agent_default_budget;
+    
             // Set state to created
             agent_table[i].state = AGENT_STATE_CREATED;
-            
+    
             // Increment count
             agent_count_value++;
-            
-            // Emit audit event for agent creation with structured record
-            char audit_msg[128];
-            build_audit_msg(audit_msg, name, "agent created", 128);
-            audit_emit(AUDIT_TYPE_AGENT_CREATED, AUDIT_RESULT_NONE, (int)i, -1, audit_msg);
-            
+            agent_dirty((int)i);
+    
             // Return agent ID (array index)
             return (int)i;
         }
@@ -120,6 +167,59 @@ int agent_create(const char* name, agent_entry_t entry, void* context) {
     return -1;
 }
 
+int agent_create(const char* name, agent_entry_t entry, void* context) {
+    int id = agent_slot_alloc(name, entry, context);
+    if (id < 0) {
+        return -1;
+    }
+    
+    // Fresh private window (slots are reused, so clear the old contents)
+    paging_space_reset(id);
+    
+    // Emit audit event for agent creation with structured record
+    char audit_msg[128];
+    ksnprintf(audit_msg, sizeof(audit_msg), "%s agent created", name);
+    audit_emit(AUDIT_TYPE_AGENT_CREATED, AUDIT_RESULT_NONE, id, -1, audit_msg);
+    
+    return id;
+}
+
+int agent_create_clone(const char* name, agent_entry_t entry, void* context, const void* image) {
+    int id = agent_slot_alloc(name, entry, context);
+    if (id < 0) {
+        return -1;
+    }
+    
+    // The window shares the image copy-on-write; nothing is cleared or copied
+    if (paging_space_clone(id, image) != 0) {
+        agent_release(id);
+        return -1;
+    }
+    return id;
+}
+
+int agent_release(int id) {
+    if (!agent_initialized || id < 0 || id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    if (agent_table[id].state != AGENT_STATE_CREATED) {
+        return -1;
+    }
+    
+    // Nothing of this agent may pass to the next one in the slot: grants,
+    // region rights, quotas, channels and region mappings. Reset the address
+    // space now too, since a warm boot restores agents into slots without
+    // agent_create() resetting them
+    cap_clear(id);
+    channel_release(id);
+    shm_release(id);
+    paging_space_reset(id);
+    agent_table[id].state = AGENT_STATE_INVALID;
+    agent_count_value--;
+    agent_dirty(id);
+    return 0;
+}
+
 int agent_run(int id) {
     // Check if initialized
     if (!agent_initialized) {
@@ -142,27 +242,135 @@ int agent_run(int id) {
         return -1;
     }
     
+    // Finish loading (the load step audits why it failed)
+    if (agent->prepare != 0 && agent->prepare(id) != 0) {
+        agent->state = AGENT_STATE_COMPLETED;
+        agent_dirty(id);
+        return -1;
+    }
+    
+    TRACE_BEGIN(TRACE_AGENT_RUN, id);
+    
     // Update state to running
     agent->state = AGENT_STATE_RUNNING;
+    agent_dirty(id);
     
     // Emit audit event for agent started with structured record
     char audit_msg[128];
-    build_audit_msg(audit_msg, agent->name, "agent started", 128);
+    ksnprintf(audit_msg, sizeof(audit_msg), "%s agent started", agent->name);
     audit_emit(AUDIT_TYPE_AGENT_STARTED, AUDIT_RESULT_NONE, id, -1, audit_msg);
     
-    // Call agent entry point with context
-    agent->entry(agent->context);
+    // Agents holding CAP_AUDIT_READ tail the audit log through a read-only
+    // mapping of the ring instead of syscalls; the mapping lasts for this run
+    int audit_mapped = 0;
+    if (cap_has(id, CAP_AUDIT_READ) &&
+        paging_map_user(id, PAGING_AUDIT_VIEW, audit_view(), AUDIT_VIEW_PAGES, 0) == 0) {
+        audit_mapped = 1;
+        audit_emit(AUDIT_TYPE_AGENT_STARTED, AUDIT_RESULT_ALLOW, id, -1, "Audit view mapped read-only");
+    }
+    
+    // Call agent entry point with context, in ring 3 in the agent's own address space
+    agent_budget_pending = 0;
+    agent_run_start = clock_cycles();
+    agent_idle_start = timer_idle_cycles();
+    agent_current_id = id;
+    bootprof_agent_entry();
+    paging_switch(id);
+    long exit_code = usermode_run(agent->entry, agent->context);
+    paging_switch(PAGING_KERNEL_SPACE);
+    agent_current_id = -1;
+    agent->cpu_cycles = agent_cpu_now();
+    
+    // An alarm must not outlive the run that armed it
+    sleep_agent_exit(id);
+    
+    if (audit_mapped) {
+        paging_unmap_user(id, PAGING_AUDIT_VIEW, AUDIT_VIEW_PAGES);
+    }
     
     // Update state to completed
     agent->state = AGENT_STATE_COMPLETED;
+    agent_dirty(id);
     
     // Emit audit event for agent completed with structured record
-    build_audit_msg(audit_msg, agent->name, "agent completed", 128);
-    audit_emit(AUDIT_TYPE_AGENT_COMPLETED, AUDIT_RESULT_SUCCESS, id, -1, audit_msg);
+    // (a faulting or over-budget agent was already reported as AGENT_ERROR)
+    unsigned int cpu_us = (unsigned int)clock_div64(agent->cpu_cycles * 1000, clock_cycles_per_ms());
+    if (exit_code == USERMODE_EXIT_FAULT || exit_code == USERMODE_EXIT_BUDGET) {
+        ksnprintf(audit_msg, sizeof(audit_msg), "%s agent terminated (%u us CPU)", agent->name, cpu_us);
+        audit_emit(AUDIT_TYPE_AGENT_COMPLETED, AUDIT_RESULT_FAILURE, id, -1, audit_msg);
+    } else {
+        ksnprintf(audit_msg, sizeof(audit_msg), "%s agent completed (%u us CPU)", agent->name, cpu_us);
+        audit_emit(AUDIT_TYPE_AGENT_COMPLETED, AUDIT_RESULT_SUCCESS, id, -1, audit_msg);
+    }
+    
+    TRACE_END(TRACE_AGENT_RUN, id);
     
     return 0;
 }
 
+int agent_set_prepare(int id, agent_prepare_t prepare) {
+    if (!agent_initialized || id < 0 || id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    if (agent_table[id].state != AGENT_STATE_CREATED) {
+        return -1;
+    }
+    
+    agent_table[id].prepare = prepare;
+    agent_dirty(id);
+    return 0;
+}
+
+int agent_current(void) {
+    return agent_current_id;
+}
+
 unsigned int agent_count(void) {
     return agent_count_value;
 }
+
+unsigned int agent_capacity(void) {
+    return agent_slot_limit;
+}
+
+int agent_find(const char* name) {
+    if (!agent_initialized || name == 0) {
+        return -1;
+    }
+    for (unsigned int i = 0; i < AGENT_MAX_COUNT; i++) {
+        if (agent_table[i].state != AGENT_STATE_INVALID &&
+            strcmp(agent_table[i].name, name) == 0) {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+int agent_set_budget(int id, unsigned int ms) {
+    if (!agent_initialized || id < 0 || id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    if (agent_table[id].state == AGENT_STATE_INVALID) {
+        return -1;
+    }
+    
+    agent_table[id].budget_cycles = (unsigned long long)ms * clock_cycles_per_ms();
+    agent_dirty(id);
+    return 0;
+}
+
+unsigned long long agent_cpu_cycles(int id) {
+    if (id < 0 || id >= AGENT_MAX_COUNT) {
+        return 0;
+    }
+    if (id == agent_current_id) {
+        return agent_cpu_now();
+    }
+    return agent_table[id].cpu_cycles;
+}
+
+void agent_budget_check(void) {
+    if (agent_budget_pending && agent_current_id >= 0) {
+        agent_budget_stop();
+    }
+}
@@ -10,6 +10,10 @@
 // Maximum agent name length (including null terminator)
 #define AGENT_NAME_MAX 64
 
+// CPU budget of a new agent in milliseconds of CPU time (0 = unlimited);
+// budget_ms= on the kernel command line overrides it
+#define AGENT_DEFAULT_BUDGET_MS 1000
+
 // Agent state
 typedef enum {
     AGENT_STATE_INVALID = 0,  // Unused slot
@@ -19,14 +23,23 @@ typedef enum {
 } agent_state_t;
 
 // Agent entry function type: void entry(void* context)
+// Entries run in ring 3 and must be USER_TEXT (see kernel/user/user.h)
 typedef void (*agent_entry_t)(void* context);
 
+// Deferred load step run by agent_run() before the first entry into ring 3
+// (e.g. a boot module's relocations); reports its own failures
+// Returns: 0 when the agent is ready to run, -1 to fail the run
+typedef int (*agent_prepare_t)(int id);
+
 // Agent structure
 typedef struct {
     char name[AGENT_NAME_MAX];      // Agent name (null-terminated)
     agent_entry_t entry;             // Entry point function
+    agent_prepare_t prepare;         // Load step before the run (0 = none)
     void* context;                   // Context pointer passed to entry
     agent_state_t state;             // Current state
+    unsigned long long cpu_cycles;   // TSC cycles used by its run (time halted in sleeps excluded)
+    unsigned long long budget_cycles; // CPU budget for the run (0 = unlimited)
 } agent_t;
 
 // Initialize the agent system
@@ -36,11 +49,56 @@ void agent_init(void);
 // Returns: agent ID (0-15) on success, -1 on failure (table full or invalid args)
 int agent_create(const char* name, agent_entry_t entry, void* context);
 
-// Run an agent by ID
+// Create an agent whose private window starts as a copy-on-write clone of
+// image (PAGING_AGENT_PAGES page-aligned pages; see paging_space_clone())
+// Not audited: the caller records the creation (agent_spawn_from_template()
+// emits one record per burst)
+// Returns: agent ID on success, -1 on failure (table full or invalid args)
+int agent_create_clone(const char* name, agent_entry_t entry, void* context, const void* image);
+
+// Free the slot of an agent that was created but never run (its setup
+// failed, or a benchmark clone), so a later agent can reuse it. Its
+// capabilities, quotas, channels and region mappings are dropped and its
+// address space is reset, so the next agent in the slot inherits nothing
+// Returns: 0 on success, -1 on failure (invalid ID or agent not in CREATED state)
+int agent_release(int id);
+
+// Run an agent by ID in ring 3 in its own address space, until it returns,
+// exits, faults, or uses up its CPU budget (a fault or budget stop completes
+// the agent with a FAILURE result)
 // Returns: 0 on success, -1 on failure (invalid ID or agent not in CREATED state)
 int agent_run(int id);
 
+// Set the load step agent_run() performs before entering the agent
+// Returns: 0 on success, -1 on failure (invalid ID or agent not in CREATED state)
+int agent_set_prepare(int id, agent_prepare_t prepare);
+
+// Get the ID of the agent currently running (system calls act on its behalf)
+// Returns: agent ID, or -1 when the kernel itself is running
+int agent_current(void);
+
 // Get the number of created agents
 unsigned int agent_count(void);
 
+// Get the number of usable agent slots (agents= tunable, <= AGENT_MAX_COUNT)
+unsigned int agent_capacity(void);
+
+// Look up an agent by name (e.g. after a snapshot restore, which brings
+// agents back without their creation calls)
+// Returns: ID of the first agent with that name, or -1 if there is none
+int agent_find(const char* name);
+
+// Set an agent's CPU budget before it runs (ms of CPU time, 0 = unlimited)
+// Enforced from the timer tick: an agent over budget in ring 3 is stopped at
+// once, one over budget in a system call when the call returns
+// Returns: 0 on success, -1 on failure (invalid ID)
+int agent_set_budget(int id, unsigned int ms);
+
+// Get the CPU time an agent has used, in TSC cycles (so far, while it runs)
+unsigned long long agent_cpu_cycles(int id);
+
+// Stop the running agent if it went over budget inside the kernel
+// Called by the system call layer before returning to ring 3
+void agent_budget_check(void);
+
 #endif // AGENT_H
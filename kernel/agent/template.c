@@ -0,0 +1,161 @@
+// AgentOS Agent Template Module Implementation
+// Week 3: Named agent templates and burst spawning from a pre-built image
+
+#include "template.h"
+#include "audit/audit.h"
+#include "clock/clock.h"
+#include "serial.h"
+#include "user/user.h"    // For user_bench_entry
+#include "lib/string.h"
+#include "lib/format.h"
+
+// Template table entry
+typedef struct {
+    int in_use;
+    int frozen;                  // Spawned at least once: the image is shared
+    char name[AGENT_NAME_MAX];
+    agent_entry_t entry;
+    cap_mask_t caps;
+    quota_t quota;
+    int has_quota;
+    unsigned int budget_ms;
+} agent_template_t;
+
+static agent_template_t template_table[AGENT_TEMPLATE_MAX];
+
+// Window images (fixed-size, no allocator); clones map these read-only
+static unsigned char template_images[AGENT_TEMPLATE_MAX][PAGING_AGENT_WINDOW_SIZE] __attribute__((aligned(PAGE_SIZE)));
+
+void agent_template_init(void) {
+    // Nothing to clear: the table starts zeroed in BSS (no template in use)
+}
+
+int agent_template_create(const char* name, agent_entry_t entry, cap_mask_t caps,
+                          const quota_t* quota, unsigned int budget_ms) {
+    if (name == 0 || entry == 0 || strnlen(name, AGENT_NAME_MAX) >= AGENT_NAME_MAX) {
+        return -1;
+    }
+    
+    for (int id = 0; id < AGENT_TEMPLATE_MAX; id++) {
+        agent_template_t* t = &template_table[id];
+        if (t->in_use) {
+            continue;
+        }
+    
+        strlcpy(t->name, name, AGENT_NAME_MAX);
+        t->entry = entry;
+        t->caps = caps;
+        t->has_quota = quota != 0;
+        if (quota != 0) {
+            t->quota.rate = quota->rate;
+            t->quota.burst = quota->burst;
+        }
+        t->budget_ms = budget_ms;
+        t->frozen = 0;
+        t->in_use = 1;
+        memset(template_images[id], 0, PAGING_AGENT_WINDOW_SIZE);
+        return id;
+    }
+    return -1;
+}
+
+void* agent_template_image(int template_id) {
+    if (template_id < 0 || template_id >= AGENT_TEMPLATE_MAX) {
+        return 0;
+    }
+    agent_template_t* t = &template_table[template_id];
+    if (!t->in_use || t->frozen) {
+        return 0;
+    }
+    return template_images[template_id];
+}
+
+int agent_template_destroy(int template_id) {
+    if (template_id < 0 || template_id >= AGENT_TEMPLATE_MAX || !template_table[template_id].in_use) {
+        return -1;
+    }
+    
+    // The image is cleared when the slot is reused (agent_template_create())
+    template_table[template_id].in_use = 0;
+    template_table[template_id].frozen = 0;
+    return 0;
+}
+
+int agent_spawn_from_template(int template_id, unsigned int count, void* context, int* ids) {
+    if (template_id < 0 || template_id >= AGENT_TEMPLATE_MAX || ids == 0 || count == 0) {
+        return -1;
+    }
+    agent_template_t* t = &template_table[template_id];
+    if (!t->in_use || count > agent_capacity() - agent_count()) {
+        return -1;
+    }
+    t->frozen = 1;
+    
+    // Slots are checked above and agents are only created here, so every
+    // clone succeeds; a failure would mean a broken image. All or nothing:
+    // the clones made so far are released again, grants included
+    for (unsigned int i = 0; i < count; i++) {
+        ids[i] = agent_create_clone(t->name, t->entry, context, template_images[template_id]);
+        if (ids[i] < 0 ||
+            cap_grant_unaudited(ids[i], t->caps, t->has_quota ? &t->quota : 0) != 0 ||
+            agent_set_budget(ids[i], t->budget_ms) != 0) {
+            for (unsigned int j = 0; j <= i; j++) {
+                if (ids[j] >= 0) {
+                    agent_release(ids[j]);
+                }
+            }
+            audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Template spawn failed");
+            return -1;
+        }
+    }
+    
+    // One record for the burst: "Spawned N <name> agents from template (first ID F, caps 0xC)"
+    char audit_msg[AUDIT_MSG_MAX];
+    ksnprintf(audit_msg, sizeof(audit_msg), "Spawned %u %s agents from template (first ID %d, caps 0x%x)",
+              count, t->name, ids[0], t->caps);
+    audit_emit(AUDIT_TYPE_AGENT_CREATED, AUDIT_RESULT_SUCCESS, ids[0], -1, audit_msg);
+    return 0;
+}
+
+void agent_template_bench(void) {
+    char line[64];
+    int ids[AGENT_MAX_COUNT];
+    
+    // Every usable slot per burst, so the table must start empty
+    unsigned int count = agent_capacity();
+    if (agent_count() != 0) {
+        serial_write("BENCH template_spawn skipped (agent table not empty)\n");
+        return;
+    }
+    int template_id = agent_template_create("spawnbench", user_bench_entry, CAP_NONE, 0, 0);
+    if (template_id < 0) {
+        serial_write("BENCH template_spawn skipped (template table full)\n");
+        return;
+    }
+    
+    // Only the spawns are timed; releasing the clones is not
+    unsigned long long cycles = 0;
+    for (unsigned int burst = 0; burst < AGENT_TEMPLATE_BENCH_BURSTS; burst++) {
+        unsigned long long start = clock_cycles();
+        int result = agent_spawn_from_template(template_id, count, 0, ids);
+        cycles += clock_cycles() - start;
+        if (result != 0) {
+            agent_template_destroy(template_id);
+            serial_write("BENCH template_spawn skipped (spawn failed)\n");
+            return;
+        }
+        for (unsigned int i = 0; i < count; i++) {
+            agent_release(ids[i]);
+        }
+    }
+    
+    // Every clone is gone, so the template slot can go too
+    agent_template_destroy(template_id);
+    
+    ksnprintf(line, sizeof(line), "BENCH template_spawn %u cycles\n",
+              (unsigned int)clock_div64(cycles, count * AGENT_TEMPLATE_BENCH_BURSTS));
+    serial_write(line);
+    ksnprintf(line, sizeof(line), "BENCH-INFO template_spawn agents=%u bursts=%u\n",
+              count, AGENT_TEMPLATE_BENCH_BURSTS);
+    serial_write(line);
+}
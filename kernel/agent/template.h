@@ -0,0 +1,53 @@
+// AgentOS Agent Template Module
+// Week 3: Named agent templates and burst spawning from a pre-built image
+
+#ifndef TEMPLATE_H
+#define TEMPLATE_H
+
+#include "agent.h"
+#include "cap/cap.h"              // For cap_mask_t, quota_t
+#include "arch/x86_64/paging.h"   // For PAGING_AGENT_WINDOW_SIZE
+
+// Maximum number of templates
+#define AGENT_TEMPLATE_MAX 4
+
+// Initialize the template table (no templates)
+void agent_template_init(void);
+
+// Create a named template: entry point, capability set with an optional
+// intent quota (null = unlimited), CPU budget in ms (0 = unlimited), and a
+// zeroed window image (see agent_template_image())
+// Returns: template ID on success, -1 on failure (invalid args or table full)
+int agent_template_create(const char* name, agent_entry_t entry, cap_mask_t caps,
+                          const quota_t* quota, unsigned int budget_ms);
+
+// Window image of a template, PAGING_AGENT_WINDOW_SIZE bytes: what every
+// clone finds at PAGING_AGENT_WINDOW (pre-built data, or a pre-built stack
+// at the top). Write it before the first spawn; it is frozen afterwards
+// Returns: kernel address of the image, or 0 if the ID is invalid or frozen
+void* agent_template_image(int template_id);
+
+// Free a template slot. No clone of the template may be left (clones map
+// its image, which the next template in the slot overwrites)
+// Returns: 0 on success, -1 if the ID is invalid or not in use
+int agent_template_destroy(int template_id);
+
+// Spawn count agents from a template, all with the same context
+// Each clone gets the template's capabilities, quota and budget and a
+// copy-on-write window; the whole burst is one AGENT_CREATED audit record
+// instead of a creation plus a grant record per agent
+// All or nothing: fails without creating any agent if the table is too
+// full, and releases the clones already made if one fails to set up
+// Returns: 0 on success with the new IDs in ids, -1 on failure
+int agent_spawn_from_template(int template_id, unsigned int count, void* context, int* ids);
+
+// Bursts agent_template_bench() spawns (and releases again)
+#define AGENT_TEMPLATE_BENCH_BURSTS 8
+
+// Microbenchmark: per-agent cost of a burst spawn filling every usable
+// slot, averaged over AGENT_TEMPLATE_BENCH_BURSTS bursts; result is written
+// to serial. Needs the empty table agent_init() leaves; the clones never
+// run and are released after each burst, and the template is destroyed
+void agent_template_bench(void);
+
+#endif // TEMPLATE_H
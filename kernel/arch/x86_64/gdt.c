@@ -0,0 +1,156 @@
+// AgentOS Global Descriptor Table Implementation
+// Week 3: Flat kernel and user segments plus a TSS, owned by the kernel (not GRUB)
+
+#include "gdt.h"
+
+// Number of GDT entries (the 64-bit TSS descriptor takes two slots)
+#if defined(__x86_64__)
+#define GDT_ENTRIES 7
+#else
+#define GDT_ENTRIES 6
+#endif
+
+// GDT entry (segment descriptor)
+typedef struct {
+    unsigned short limit_low;
+    unsigned short base_low;
+    unsigned char base_mid;
+    unsigned char access;
+    unsigned char granularity;   // Flags (high nibble) | limit bits 16-19 (low nibble)
+    unsigned char base_high;
+} __attribute__((packed)) gdt_entry_t;
+
+// GDTR register image
+typedef struct {
+    unsigned short limit;
+    unsigned long base;
+} __attribute__((packed)) gdt_ptr_t;
+
+// Code segment flags: 64-bit (L) in long mode, 32-bit default size (D) otherwise
+#if defined(__x86_64__)
+#define GDT_CODE_FLAGS 0xA0
+#else
+#define GDT_CODE_FLAGS 0xC0
+#endif
+
+// Task state segment: only the ring-0 stack is used (no hardware task switching,
+// no I/O bitmap)
+#if defined(__x86_64__)
+typedef struct {
+    unsigned int reserved0;
+    unsigned long rsp0;          // Stack loaded on entry from ring 3
+    unsigned long rsp1;
+    unsigned long rsp2;
+    unsigned long reserved1;
+    unsigned long ist[7];
+    unsigned long reserved2;
+    unsigned short reserved3;
+    unsigned short iomap_base;
+} __attribute__((packed)) tss_t;
+#else
+typedef struct {
+    unsigned int prev_task;
+    unsigned int esp0;           // Stack loaded on entry from ring 3
+    unsigned int ss0;
+    unsigned int unused[22];     // esp1..ldt: unused without hardware task switching
+    unsigned short trap;
+    unsigned short iomap_base;
+} __attribute__((packed)) tss_t;
+#endif
+
+// Descriptor table and TSS (fixed-size, no heap)
+static gdt_entry_t gdt[GDT_ENTRIES];
+static tss_t tss;
+
+// Fill one descriptor
+static void gdt_set_entry(unsigned int index, unsigned int base, unsigned int limit, unsigned char access, unsigned char flags) {
+    gdt[index].limit_low = (unsigned short)(limit & 0xFFFF);
+    gdt[index].base_low = (unsigned short)(base & 0xFFFF);
+    gdt[index].base_mid = (unsigned char)((base >> 16) & 0xFF);
+    gdt[index].access = access;
+    gdt[index].granularity = (unsigned char)((flags & 0xF0) | ((limit >> 16) & 0x0F));
+    gdt[index].base_high = (unsigned char)((base >> 24) & 0xFF);
+}
+
+void gdt_init(void) {
+    // Null descriptor
+    gdt_set_entry(0, 0, 0, 0, 0);
+    
+    // Kernel code: base 0, limit 4 GiB, present, ring 0, executable/readable, 4 KiB granularity
+    // (64-bit on x86_64, where base and limit are ignored)
+    gdt_set_entry(1, 0, 0xFFFFF, 0x9A, GDT_CODE_FLAGS);
+    
+    // Kernel data: base 0, limit 4 GiB, present, ring 0, writable, 32-bit, 4 KiB granularity
+    gdt_set_entry(2, 0, 0xFFFFF, 0x92, 0xC0);
+    
+    // User code and data: same flat segments at ring 3, ordered for sysret/sysexit
+    gdt_set_entry(GDT_USER_CODE >> 3, 0, 0xFFFFF, 0xFA, GDT_CODE_FLAGS);
+    gdt_set_entry(GDT_USER_DATA >> 3, 0, 0xFFFFF, 0xF2, 0xC0);
+    
+    // TSS: present, ring 0, available 32/64-bit TSS, byte granularity
+    unsigned long tss_base = (unsigned long)&tss;
+    tss.iomap_base = (unsigned short)sizeof(tss);  // Past the limit: no I/O bitmap
+#if !defined(__x86_64__)
+    tss.ss0 = GDT_KERNEL_DATA;
+#endif
+    gdt_set_entry(GDT_TSS >> 3, (unsigned int)tss_base, sizeof(tss) - 1, 0x89, 0x00);
+#if defined(__x86_64__)
+    // Upper half of the 16-byte system descriptor: base bits 32-63
+    gdt_set_entry((GDT_TSS >> 3) + 1, 0, 0, 0, 0);
+    gdt[(GDT_TSS >> 3) + 1].limit_low = (unsigned short)((tss_base >> 32) & 0xFFFF);
+    gdt[(GDT_TSS >> 3) + 1].base_low = (unsigned short)((tss_base >> 48) & 0xFFFF);
+#endif
+    
+    gdt_ptr_t gdtr;
+    gdtr.limit = (unsigned short)(sizeof(gdt) - 1);
+    gdtr.base = (unsigned long)gdt;
+    
+#if defined(__x86_64__)
+    // Load GDTR, reload data segments, then far-return to reload CS
+    // (long mode has no far jump with an immediate selector)
+    __asm__ volatile (
+        "lgdt %0\n\t"
+        "movw %1, %%ax\n\t"
+        "movw %%ax, %%ds\n\t"
+        "movw %%ax, %%es\n\t"
+        "movw %%ax, %%fs\n\t"
+        "movw %%ax, %%gs\n\t"
+        "movw %%ax, %%ss\n\t"
+        "pushq %2\n\t"
+        "leaq 1f(%%rip), %%rax\n\t"
+        "pushq %%rax\n\t"
+        "lretq\n\t"
+        "1:\n\t"
+        :
+        : "m"(gdtr), "i"(GDT_KERNEL_DATA), "i"(GDT_KERNEL_CODE)
+        : "rax", "memory"
+    );
+#else
+    // Load GDTR, reload data segments, then far-jump to reload CS
+    __asm__ volatile (
+        "lgdt %0\n\t"
+        "movw %1, %%ax\n\t"
+        "movw %%ax, %%ds\n\t"
+        "movw %%ax, %%es\n\t"
+        "movw %%ax, %%fs\n\t"
+        "movw %%ax, %%gs\n\t"
+        "movw %%ax, %%ss\n\t"
+        "ljmp %2, $1f\n\t"
+        "1:\n\t"
+        :
+        : "m"(gdtr), "i"(GDT_KERNEL_DATA), "i"(GDT_KERNEL_CODE)
+        : "eax", "memory"
+    );
+#endif
+    
+    // Load the task register (marks the TSS descriptor busy)
+    __asm__ volatile ("ltr %w0" : : "r"(GDT_TSS) : "memory");
+}
+
+void gdt_set_kernel_stack(unsigned long sp) {
+#if defined(__x86_64__)
+    tss.rsp0 = sp;
+#else
+    tss.esp0 = (unsigned int)sp;
+#endif
+}
@@ -0,0 +1,33 @@
+// AgentOS Global Descriptor Table
+// Week 3: Flat kernel and user segments plus a TSS, owned by the kernel (not GRUB)
+
+#ifndef ARCH_GDT_H
+#define ARCH_GDT_H
+
+// Segment selectors
+#define GDT_KERNEL_CODE 0x08
+#define GDT_KERNEL_DATA 0x10
+
+// User selectors (RPL 3); their order is fixed by the fast syscall instructions
+#if defined(__x86_64__)
+// sysret loads SS from STAR base + 8 and CS from STAR base + 16
+#define GDT_USER_DATA 0x1B
+#define GDT_USER_CODE 0x23
+#else
+// sysexit loads CS from SYSENTER_CS + 16 and SS from SYSENTER_CS + 24
+#define GDT_USER_CODE 0x1B
+#define GDT_USER_DATA 0x23
+#endif
+
+// Task state segment (only the ring-0 stack pointer is used)
+#define GDT_TSS 0x28
+
+// Load the kernel GDT and reload all segment registers
+// GRUB's GDT lives in memory the kernel does not own, so this must run
+// before interrupts are enabled
+void gdt_init(void);
+
+// Set the stack the CPU switches to on an interrupt or exception from ring 3
+void gdt_set_kernel_stack(unsigned long sp);
+
+#endif // ARCH_GDT_H
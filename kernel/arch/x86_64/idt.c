@@ -0,0 +1,160 @@
+// AgentOS Interrupt Descriptor Table Implementation
+// Week 3: Exception and IRQ vectors with a C dispatch table
+
+#include "idt.h"
+#include "gdt.h"
+#include "pic.h"
+#include "vga.h"
+#include "serial.h"
+#include "usermode.h"
+#include "paging.h"  // For paging_cow_fault
+#include "lib/format.h"
+
+// IDT gate descriptor
+#if defined(__x86_64__)
+typedef struct {
+    unsigned short offset_low;
+    unsigned short selector;
+    unsigned char ist;           // Interrupt stack table slot (0 = none)
+    unsigned char type_attr;
+    unsigned short offset_mid;
+    unsigned int offset_high;
+    unsigned int reserved;
+} __attribute__((packed)) idt_entry_t;
+#else
+typedef struct {
+    unsigned short offset_low;
+    unsigned short selector;
+    unsigned char zero;
+    unsigned char type_attr;
+    unsigned short offset_high;
+} __attribute__((packed)) idt_entry_t;
+#endif
+
+// IDTR register image
+typedef struct {
+    unsigned short limit;
+    unsigned long base;
+} __attribute__((packed)) idt_ptr_t;
+
+// Gate type: present, ring 0, interrupt gate (clears IF on entry)
+// Same encoding for 32-bit and 64-bit gates
+#define IDT_GATE_INTERRUPT 0x8E
+
+// Gate type: present, ring 3 may invoke, trap gate (IF stays set, so the
+// system call runs interruptible like the sysenter/syscall path)
+#define IDT_GATE_USER_TRAP 0xEF
+
+// Stub addresses exported by isr.S / isr64.S
+extern unsigned long isr_stub_table[IDT_STUB_COUNT];
+extern char isr_stub_128[];
+
+// Descriptor table and C handler table (fixed-size, no heap)
+static idt_entry_t idt[IDT_ENTRIES];
+static interrupt_handler_t interrupt_handlers[IDT_ENTRIES];
+
+// Exception names for the panic message
+static const char* exception_names[32] = {
+    "divide error", "debug", "NMI", "breakpoint", "overflow", "bound range",
+    "invalid opcode", "device not available", "double fault", "coprocessor overrun",
+    "invalid TSS", "segment not present", "stack fault", "general protection",
+    "page fault", "reserved", "x87 FPU error", "alignment check", "machine check",
+    "SIMD exception", "virtualization", "control protection", "reserved", "reserved",
+    "reserved", "reserved", "reserved", "reserved", "hypervisor injection",
+    "VMM communication", "security exception", "reserved",
+};
+
+// Fill one gate
+static void idt_set_gate(unsigned int vector, unsigned long handler, unsigned char type_attr) {
+    idt[vector].offset_low = (unsigned short)(handler & 0xFFFF);
+    idt[vector].selector = GDT_KERNEL_CODE;
+    idt[vector].type_attr = type_attr;
+#if defined(__x86_64__)
+    idt[vector].ist = 0;
+    idt[vector].offset_mid = (unsigned short)((handler >> 16) & 0xFFFF);
+    idt[vector].offset_high = (unsigned int)(handler >> 32);
+    idt[vector].reserved = 0;
+#else
+    idt[vector].zero = 0;
+    idt[vector].offset_high = (unsigned short)((handler >> 16) & 0xFFFF);
+#endif
+}
+
+// Report an unhandled CPU exception on both consoles and stop
+static void exception_panic(interrupt_frame_t* frame) {
+    char msg[128];
+    unsigned int pos = ksnprintf(msg, sizeof(msg), "\nKERNEL PANIC: %s at pc=0x%08lx err=0x%08lx",
+                                 exception_names[frame->vector],
+                                 (unsigned long)INTERRUPT_FRAME_PC(frame), (unsigned long)frame->error_code);
+    if (frame->vector == 14) {
+        // Page fault: CR2 holds the faulting address
+        unsigned long cr2;
+        __asm__ volatile ("mov %%cr2, %0" : "=r"(cr2));
+        pos += ksnprintf(msg + pos, sizeof(msg) - pos, " addr=0x%08lx", cr2);
+    }
+    ksnprintf(msg + pos, sizeof(msg) - pos, "\n");
+    vga_write(msg);
+    vga_flush();  // The fault may have hit inside a console batch
+    serial_write(msg);
+    
+    interrupts_disable();
+    while (1) {
+        __asm__ volatile ("hlt");
+    }
+}
+
+void idt_init(void) {
+    for (unsigned int v = 0; v < IDT_ENTRIES; v++) {
+        interrupt_handlers[v] = 0;
+    }
+    for (unsigned int v = 0; v < IDT_STUB_COUNT; v++) {
+        idt_set_gate(v, isr_stub_table[v], IDT_GATE_INTERRUPT);
+    }
+    idt_set_gate(IDT_VECTOR_SYSCALL, (unsigned long)isr_stub_128, IDT_GATE_USER_TRAP);
+    
+    idt_ptr_t idtr;
+    idtr.limit = (unsigned short)(sizeof(idt) - 1);
+    idtr.base = (unsigned long)idt;
+    __asm__ volatile ("lidt %0" : : "m"(idtr) : "memory");
+}
+
+int interrupt_register(unsigned int vector, interrupt_handler_t handler) {
+    if (vector >= IDT_ENTRIES || handler == 0) {
+        return -1;
+    }
+    if (interrupt_handlers[vector] != 0) {
+        return -1;
+    }
+    interrupt_handlers[vector] = handler;
+    return 0;
+}
+
+// Called from isr_common; interrupts are disabled, except for vector 0x80
+// (int 0x80 is a trap gate, so its handler runs with interrupts enabled)
+void interrupt_dispatch(interrupt_frame_t* frame) {
+    unsigned int vector = frame->vector;
+    interrupt_handler_t handler = interrupt_handlers[vector];
+    
+    // Acknowledge IRQs up front so handlers are free not to return normally
+    if (vector >= PIC_IRQ_BASE && vector < PIC_IRQ_BASE + PIC_IRQ_COUNT) {
+        pic_eoi(vector - PIC_IRQ_BASE);
+    }
+    
+    if (handler != 0) {
+        handler(frame);
+        return;
+    }
+    
+    // A write to a copy-on-write page is not an error: copy it and retry
+    if (vector == IDT_VECTOR_PAGE_FAULT && paging_cow_fault(frame)) {
+        return;
+    }
+    
+    if (vector < 32) {
+        // A faulting ring-3 agent is terminated; the kernel keeps running
+        if (INTERRUPT_FRAME_FROM_USER(frame)) {
+            usermode_fault(frame, exception_names[vector]);
+        }
+        exception_panic(frame);
+    }
+}
@@ -0,0 +1,110 @@
+// AgentOS Interrupt Descriptor Table
+// Week 3: Exception and IRQ vectors with a C dispatch table
+
+#ifndef ARCH_IDT_H
+#define ARCH_IDT_H
+
+// Vectors with assembly stubs: 32 CPU exceptions + 16 PIC IRQs
+#define IDT_STUB_COUNT 48
+
+// Total IDT entries
+#define IDT_ENTRIES 256
+
+// Software interrupt vector for the int 0x80 system call gate
+#define IDT_VECTOR_SYSCALL 0x80
+
+// Page fault exception vector (resolved first by paging_cow_fault())
+#define IDT_VECTOR_PAGE_FAULT 14
+
+#if defined(__x86_64__)
+
+// Register state saved by the common interrupt stub (see isr64.S)
+// Long mode always pushes rsp/ss, from any privilege level
+typedef struct {
+    unsigned long r15, r14, r13, r12, r11, r10, r9, r8;
+    unsigned long rdi, rsi, rbp, rbx, rdx, rcx, rax;
+    unsigned long vector;
+    unsigned long error_code;
+    unsigned long rip, cs, rflags, rsp, ss;            // Pushed by the CPU
+} interrupt_frame_t;
+
+// Interrupted instruction and frame pointers
+#define INTERRUPT_FRAME_PC(frame) ((frame)->rip)
+#define INTERRUPT_FRAME_FP(frame) ((frame)->rbp)
+
+// System call registers for the int 0x80 gate: rax = number, rdi/rsi/rdx = arguments
+#define INTERRUPT_FRAME_SYSCALL_NR(frame) ((frame)->rax)
+#define INTERRUPT_FRAME_ARG1(frame) ((frame)->rdi)
+#define INTERRUPT_FRAME_ARG2(frame) ((frame)->rsi)
+#define INTERRUPT_FRAME_ARG3(frame) ((frame)->rdx)
+#define INTERRUPT_FRAME_RET(frame) ((frame)->rax)
+
+#else
+
+// Register state saved by the common interrupt stub (see isr.S)
+// user_esp/user_ss are only valid when the interrupt came from ring 3
+typedef struct {
+    unsigned int ds;
+    unsigned int edi, esi, ebp, esp, ebx, edx, ecx, eax;  // pusha order
+    unsigned int vector;
+    unsigned int error_code;
+    unsigned int eip, cs, eflags;                        // Pushed by the CPU
+    unsigned int user_esp, user_ss;
+} interrupt_frame_t;
+
+// Interrupted instruction and frame pointers
+#define INTERRUPT_FRAME_PC(frame) ((frame)->eip)
+#define INTERRUPT_FRAME_FP(frame) ((frame)->ebp)
+
+// System call registers for the int 0x80 gate: eax = number, ebx/esi/edi = arguments
+#define INTERRUPT_FRAME_SYSCALL_NR(frame) ((frame)->eax)
+#define INTERRUPT_FRAME_ARG1(frame) ((frame)->ebx)
+#define INTERRUPT_FRAME_ARG2(frame) ((frame)->esi)
+#define INTERRUPT_FRAME_ARG3(frame) ((frame)->edi)
+#define INTERRUPT_FRAME_RET(frame) ((frame)->eax)
+
+#endif
+
+// Check whether the interrupt arrived from ring 3
+#define INTERRUPT_FRAME_FROM_USER(frame) (((frame)->cs & 3) == 3)
+
+// Interrupt handler function type
+typedef void (*interrupt_handler_t)(interrupt_frame_t* frame);
+
+// Build the IDT for all stub vectors and load it (interrupts stay disabled)
+void idt_init(void);
+
+// Register a handler for a vector (0-255)
+// IRQ handlers are acknowledged at the PIC before they run, so a handler
+// may switch away without returning
+// Returns: 0 on success, -1 on failure (invalid vector or already registered)
+int interrupt_register(unsigned int vector, interrupt_handler_t handler);
+
+// Common C entry for every stub vector (called from isr.S, interrupts disabled)
+void interrupt_dispatch(interrupt_frame_t* frame);
+
+// Enable maskable interrupts
+static inline void interrupts_enable(void) {
+    __asm__ volatile ("sti" : : : "memory");
+}
+
+// Disable maskable interrupts
+static inline void interrupts_disable(void) {
+    __asm__ volatile ("cli" : : : "memory");
+}
+
+// Disable interrupts and return the previous (E/R)FLAGS (for interrupts_restore)
+static inline unsigned long interrupts_save(void) {
+    unsigned long flags;
+    __asm__ volatile ("pushf\n\tpop %0\n\tcli" : "=r"(flags) : : "memory");
+    return flags;
+}
+
+// Restore the interrupt flag saved by interrupts_save
+static inline void interrupts_restore(unsigned long flags) {
+    if (flags & 0x200) {
+        interrupts_enable();
+    }
+}
+
+#endif // ARCH_IDT_H
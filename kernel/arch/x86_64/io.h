@@ -0,0 +1,58 @@
+// AgentOS Port I/O and CPU Helpers
+// Week 3: Inline x86 port I/O and timestamp counter access
+
+#ifndef ARCH_IO_H
+#define ARCH_IO_H
+
+// Write a byte to an I/O port
+static inline void outb(unsigned short port, unsigned char value) {
+    __asm__ volatile ("outb %0, %1" : : "a"(value), "Nd"(port));
+}
+
+// Read a byte from an I/O port
+static inline unsigned char inb(unsigned short port) {
+    unsigned char value;
+    __asm__ volatile ("inb %1, %0" : "=a"(value) : "Nd"(port));
+    return value;
+}
+
+// Write a 16-bit word to an I/O port
+static inline void outw(unsigned short port, unsigned short value) {
+    __asm__ volatile ("outw %0, %1" : : "a"(value), "Nd"(port));
+}
+
+// Read a 16-bit word from an I/O port
+static inline unsigned short inw(unsigned short port) {
+    unsigned short value;
+    __asm__ volatile ("inw %1, %0" : "=a"(value) : "Nd"(port));
+    return value;
+}
+
+// Read the CPU timestamp counter
+static inline unsigned long long rdtsc(void) {
+    unsigned int lo, hi;
+    __asm__ volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((unsigned long long)hi << 32) | lo;
+}
+
+// Execute CPUID for a leaf (subleaf 0)
+static inline void cpuid(unsigned int leaf, unsigned int* eax, unsigned int* ebx,
+                         unsigned int* ecx, unsigned int* edx) {
+    __asm__ volatile ("cpuid"
+                      : "=a"(*eax), "=b"(*ebx), "=c"(*ecx), "=d"(*edx)
+                      : "a"(leaf), "c"(0));
+}
+
+// Read a model-specific register
+static inline unsigned long long rdmsr(unsigned int msr) {
+    unsigned int lo, hi;
+    __asm__ volatile ("rdmsr" : "=a"(lo), "=d"(hi) : "c"(msr));
+    return ((unsigned long long)hi << 32) | lo;
+}
+
+// Write a model-specific register
+static inline void wrmsr(unsigned int msr, unsigned long long value) {
+    __asm__ volatile ("wrmsr" : : "c"(msr), "a"((unsigned int)value), "d"((unsigned int)(value >> 32)) : "memory");
+}
+
+#endif // ARCH_IO_H
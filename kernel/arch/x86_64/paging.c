@@ -0,0 +1,587 @@
+// AgentOS Paging Implementation
+// Week 3: Global large-page kernel identity map, per-agent ring-3 regions, PCID tags
+
+#include "paging.h"
+#include "io.h"
+#include "idt.h"
+#include "audit/audit.h"
+#include "clock/clock.h"
+#include "serial.h"
+#include "lib/string.h"
+#include "lib/format.h"
+
+// Page table entry: 32-bit on i386 (non-PAE), 64-bit in long mode
+typedef unsigned long paging_entry_t;
+
+// Entries per table (1024 on i386, 512 on x86_64)
+#define PAGING_ENTRIES (PAGE_SIZE / sizeof(paging_entry_t))
+
+// Entry flags
+#define PAGE_PRESENT 0x001
+#define PAGE_WRITE   0x002
+#define PAGE_USER    0x004  // Accessible from ring 3 (needed at every level)
+#define PAGE_LARGE   0x080  // 4 MiB (i386) / 2 MiB (x86_64) page in a directory entry
+#define PAGE_GLOBAL  0x100  // Survives CR3 loads when CR4.PGE is set
+#define PAGE_COW     0x200  // Software bit: read-only window page shared with a template
+
+// Page fault error code bits
+#define PF_PRESENT 0x1  // Protection violation (not a missing page)
+#define PF_WRITE   0x2
+
+// Control register bits
+#define CR0_WP    0x00010000  // Honour read-only pages in ring 0
+#define CR0_PG    0x80000000
+#define CR4_PSE   0x00000010
+#define CR4_PGE   0x00000080
+#define CR4_PCIDE 0x00020000
+
+// CPUID leaf 1 feature bits
+#define CPUID_EDX_PSE  (1u << 3)
+#define CPUID_EDX_PGE  (1u << 13)
+#define CPUID_ECX_PCID (1u << 17)
+
+// CR3 bit 63: keep the target PCID's cached translations on load
+#define CR3_NOFLUSH (1UL << 63)
+
+// Kernel identity map: 1 GiB of 4 MiB pages (i386) / 2 MiB pages (x86_64),
+// ending where the user region (PAGING_USER_BASE) begins
+#if defined(__x86_64__)
+#define PAGING_LARGE_SHIFT 21
+#else
+#define PAGING_KERNEL_PDES 256
+#define PAGING_LARGE_SHIFT 22
+#endif
+
+// One address space (the root table's address is also its physical address)
+typedef struct {
+    paging_entry_t* root;        // Page directory (i386) / PML4 (x86_64)
+    unsigned long pcid;          // TLB tag (0 for the kernel, agent ID + 1)
+    int tlb_valid;               // Cached translations for this PCID are current
+} paging_space_t;
+
+#define PAGING_ALIGNED __attribute__((aligned(PAGE_SIZE)))
+
+// Kernel tables (shared by every space)
+static paging_entry_t kernel_root[PAGING_ENTRIES] PAGING_ALIGNED;
+#if defined(__x86_64__)
+static paging_entry_t kernel_pdpt[PAGING_ENTRIES] PAGING_ALIGNED;
+static paging_entry_t kernel_pd[PAGING_ENTRIES] PAGING_ALIGNED;
+#endif
+
+// Ring-3 agent image (.user sections), linked at PAGING_USER_BASE and loaded
+// by GRUB at these physical addresses (see boot/linker.ld)
+extern char __user_load_start[];
+extern char __user_load_end[];
+static unsigned long paging_user_image_size = 0;
+
+// Per-agent tables and private frames (fixed-size, no allocator)
+static paging_entry_t agent_root[AGENT_MAX_COUNT][PAGING_ENTRIES] PAGING_ALIGNED;
+#if defined(__x86_64__)
+static paging_entry_t agent_pdpt[AGENT_MAX_COUNT][PAGING_ENTRIES] PAGING_ALIGNED;
+static paging_entry_t agent_pd[AGENT_MAX_COUNT][PAGING_ENTRIES] PAGING_ALIGNED;
+#endif
+static paging_entry_t agent_pt[AGENT_MAX_COUNT][PAGING_ENTRIES] PAGING_ALIGNED;
+static unsigned char agent_frames[AGENT_MAX_COUNT][PAGING_AGENT_PAGES][PAGE_SIZE] PAGING_ALIGNED;
+
+static paging_space_t kernel_space;
+static paging_space_t agent_spaces[AGENT_MAX_COUNT];
+
+// Currently loaded space (0 until paging_init succeeds)
+static paging_space_t* paging_current = 0;
+
+// CPU features in use
+static int paging_enabled = 0;
+static int paging_global = 0;
+static int paging_pcid = 0;
+
+static inline unsigned long read_cr0(void) {
+    unsigned long value;
+    __asm__ volatile ("mov %%cr0, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr0(unsigned long value) {
+    __asm__ volatile ("mov %0, %%cr0" : : "r"(value) : "memory");
+}
+
+static inline unsigned long read_cr4(void) {
+    unsigned long value;
+    __asm__ volatile ("mov %%cr4, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr4(unsigned long value) {
+    __asm__ volatile ("mov %0, %%cr4" : : "r"(value) : "memory");
+}
+
+static inline unsigned long read_cr2(void) {
+    unsigned long value;
+    __asm__ volatile ("mov %%cr2, %0" : "=r"(value));
+    return value;
+}
+
+static inline void write_cr3(unsigned long value) {
+    __asm__ volatile ("mov %0, %%cr3" : : "r"(value) : "memory");
+}
+
+// Drop every cached translation, global and all PCIDs included
+static void paging_flush_all(void) {
+    if (paging_global) {
+        unsigned long cr4 = read_cr4();
+        write_cr4(cr4 & ~(unsigned long)CR4_PGE);
+        write_cr4(cr4);
+    }
+}
+
+// Load a space into CR3
+// Without PCID the load drops all non-global entries; with PCID only the
+// first load after a reset does (the tag keeps other spaces' entries apart)
+static void paging_load(paging_space_t* space, int full_flush) {
+    unsigned long cr3 = (unsigned long)space->root;
+    
+    if (full_flush) {
+        paging_flush_all();
+        space->tlb_valid = 0;
+    }
+#if defined(__x86_64__)
+    if (paging_pcid) {
+        cr3 |= space->pcid;
+        if (space->tlb_valid) {
+            cr3 |= CR3_NOFLUSH;
+        }
+    }
+#endif
+    write_cr3(cr3);
+    space->tlb_valid = 1;
+    paging_current = space;
+}
+
+// Fill the kernel identity map with large pages
+static void paging_build_kernel(paging_entry_t flags) {
+#if defined(__x86_64__)
+    for (unsigned int i = 0; i < PAGING_ENTRIES; i++) {
+        kernel_pd[i] = ((unsigned long)i << PAGING_LARGE_SHIFT) | flags;
+    }
+    kernel_pdpt[0] = (unsigned long)kernel_pd | PAGE_PRESENT | PAGE_WRITE;
+    kernel_root[0] = (unsigned long)kernel_pdpt | PAGE_PRESENT | PAGE_WRITE;
+#else
+    for (unsigned int i = 0; i < PAGING_KERNEL_PDES; i++) {
+        kernel_root[i] = ((unsigned long)i << PAGING_LARGE_SHIFT) | flags;
+    }
+#endif
+    kernel_space.root = kernel_root;
+    kernel_space.pcid = 0;
+    kernel_space.tlb_valid = 0;
+}
+
+// Page-table index of the first window page
+#define PAGING_WINDOW_SLOT ((PAGING_AGENT_WINDOW - PAGING_USER_BASE) / PAGE_SIZE)
+
+// Page-table index of the first module view page
+#define PAGING_MODULE_SLOT ((PAGING_MODULE_VIEW - PAGING_USER_BASE) / PAGE_SIZE)
+
+// Remove an agent's module mapping (the caller invalidates its TLB entries)
+static void paging_unmap_module(int id) {
+    for (unsigned int i = 0; i < PAGING_MODULE_PAGES; i++) {
+        agent_pt[id][PAGING_MODULE_SLOT + i] = 0;
+    }
+}
+
+// Point an agent's window at its own frames, writable
+static void paging_map_window(int id) {
+    for (unsigned int i = 0; i < PAGING_AGENT_PAGES; i++) {
+        agent_pt[id][PAGING_WINDOW_SLOT + i] = (unsigned long)agent_frames[id][i] | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+    }
+}
+
+// Build one agent space: shared kernel entries plus the user region
+// (one page table: the read-only .user image, then the private window)
+static void paging_build_agent(int id) {
+    paging_entry_t* root = agent_root[id];
+    paging_entry_t* pt = agent_pt[id];
+    paging_entry_t user_table = (unsigned long)pt | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+    
+    unsigned long image = (unsigned long)__user_load_start;
+    for (unsigned int i = 0; i * PAGE_SIZE < paging_user_image_size; i++) {
+        pt[i] = (image + i * PAGE_SIZE) | PAGE_PRESENT | PAGE_USER;
+    }
+    paging_map_window(id);
+    
+#if defined(__x86_64__)
+    // PDPT slot 0 points at the kernel PD, so the kernel map is shared, not copied
+    root[0] = (unsigned long)agent_pdpt[id] | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+    agent_pdpt[id][0] = kernel_pdpt[0];
+    agent_pdpt[id][PAGING_USER_BASE >> 30] = (unsigned long)agent_pd[id] | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+    agent_pd[id][0] = user_table;
+#else
+    // Kernel directory entries are large pages and never change after init,
+    // so copying them keeps every directory consistent
+    memcpy(root, kernel_root, PAGING_KERNEL_PDES * sizeof(paging_entry_t));
+    root[PAGING_USER_BASE >> PAGING_LARGE_SHIFT] = user_table;
+#endif
+    
+    agent_spaces[id].root = root;
+    agent_spaces[id].pcid = (unsigned long)id + 1;
+    agent_spaces[id].tlb_valid = 0;
+}
+
+int paging_init(void) {
+    unsigned int eax, ebx, ecx, edx;
+    cpuid(1, &eax, &ebx, &ecx, &edx);
+    
+#if !defined(__x86_64__)
+    // Long mode always has 2 MiB pages; i386 needs PSE for 4 MiB pages
+    if (!(edx & CPUID_EDX_PSE)) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Paging disabled: CPU lacks PSE");
+        return -1;
+    }
+#endif
+    paging_global = (edx & CPUID_EDX_PGE) != 0;
+    
+    paging_user_image_size = (unsigned long)(__user_load_end - __user_load_start);
+    if (paging_user_image_size > PAGING_USER_IMAGE_MAX) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Paging disabled: .user image too large");
+        return -1;
+    }
+    
+    paging_entry_t kernel_flags = PAGE_PRESENT | PAGE_WRITE | PAGE_LARGE;
+    if (paging_global) {
+        kernel_flags |= PAGE_GLOBAL;
+    }
+    paging_build_kernel(kernel_flags);
+    for (int id = 0; id < AGENT_MAX_COUNT; id++) {
+        paging_build_agent(id);
+    }
+    
+    unsigned long flags = interrupts_save();
+#if defined(__x86_64__)
+    // Already paging on entry64.S's tables; the maps agree on 0-1 GiB
+    // WP makes kernel stores into copy-on-write pages fault too
+    paging_load(&kernel_space, 0);
+    write_cr0(read_cr0() | CR0_WP);
+    if (paging_global) {
+        write_cr4(read_cr4() | CR4_PGE);
+    }
+    // PCIDE may only be set while CR3's PCID is 0 (the kernel space)
+    if (ecx & CPUID_ECX_PCID) {
+        write_cr4(read_cr4() | CR4_PCIDE);
+        paging_pcid = 1;
+    }
+#else
+    write_cr4(read_cr4() | CR4_PSE);
+    paging_load(&kernel_space, 0);
+    write_cr0(read_cr0() | CR0_PG | CR0_WP);
+    if (paging_global) {
+        write_cr4(read_cr4() | CR4_PGE);
+    }
+#endif
+    paging_enabled = 1;
+    interrupts_restore(flags);
+    
+    char audit_msg[AUDIT_MSG_MAX];
+    ksnprintf(audit_msg, sizeof(audit_msg), "Paging enabled (global=%d, pcid=%d)",
+              paging_global, paging_pcid);
+    audit_emit(AUDIT_TYPE_SYSTEM_INIT, AUDIT_RESULT_NONE, -1, -1, audit_msg);
+    return 0;
+}
+
+int paging_space_reset(int agent_id) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    
+    // Frames are identity-mapped, so clear them through the kernel map
+    // (a previous clone in this slot may have left window pages shared)
+    memset(agent_frames[agent_id], 0, sizeof(agent_frames[agent_id]));
+    paging_map_window(agent_id);
+    paging_unmap_module(agent_id);
+    paging_unmap_user(agent_id, PAGING_SHARED_BASE, PAGING_SHARED_PAGES);
+    paging_unmap_user_large(agent_id);
+    agent_spaces[agent_id].tlb_valid = 0;
+    return 0;
+}
+
+int paging_space_clone(int agent_id, const void* image) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT || image == 0 ||
+        ((unsigned long)image & (PAGE_SIZE - 1)) != 0) {
+        return -1;
+    }
+    
+    // Nothing is copied or cleared now; the agent's frames are filled one
+    // page at a time by paging_cow_fault()
+    for (unsigned int i = 0; i < PAGING_AGENT_PAGES; i++) {
+        agent_pt[agent_id][PAGING_WINDOW_SLOT + i] =
+            ((unsigned long)image + i * PAGE_SIZE) | PAGE_PRESENT | PAGE_USER | PAGE_COW;
+    }
+    paging_unmap_module(agent_id);
+    paging_unmap_user(agent_id, PAGING_SHARED_BASE, PAGING_SHARED_PAGES);
+    paging_unmap_user_large(agent_id);
+    agent_spaces[agent_id].tlb_valid = 0;
+    return 0;
+}
+
+int paging_map_module(int agent_id, const void* image, unsigned int pages) {
+    unsigned long base = (unsigned long)image;
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT || image == 0 || pages == 0 ||
+        pages > PAGING_MODULE_PAGES || (base & (PAGE_SIZE - 1)) != 0) {
+        return -1;
+    }
+    
+    // Must lie in the kernel identity map, which is also how the module
+    // loader patches it in place
+    if (base >= PAGING_USER_BASE || pages > (PAGING_USER_BASE - base) / PAGE_SIZE) {
+        return -1;
+    }
+    
+    paging_unmap_module(agent_id);
+    for (unsigned int i = 0; i < pages; i++) {
+        agent_pt[agent_id][PAGING_MODULE_SLOT + i] = (base + i * PAGE_SIZE) | PAGE_PRESENT | PAGE_USER;
+    }
+    agent_spaces[agent_id].tlb_valid = 0;
+    return 0;
+}
+
+int paging_cow_fault(interrupt_frame_t* frame) {
+    if ((frame->error_code & (PF_PRESENT | PF_WRITE)) != (PF_PRESENT | PF_WRITE)) {
+        return 0;
+    }
+    if (paging_current == 0 || paging_current == &kernel_space) {
+        return 0;
+    }
+    unsigned long addr = read_cr2();
+    if (addr < PAGING_AGENT_WINDOW || addr >= PAGING_AGENT_WINDOW + PAGING_AGENT_WINDOW_SIZE) {
+        return 0;
+    }
+    
+    int id = (int)(paging_current - agent_spaces);
+    unsigned int page = (unsigned int)((addr - PAGING_AGENT_WINDOW) / PAGE_SIZE);
+    paging_entry_t* pte = &agent_pt[id][PAGING_WINDOW_SLOT + page];
+    if (!(*pte & PAGE_COW)) {
+        return 0;
+    }
+    
+    // Copy the shared page into the agent's own frame and make it writable
+    memcpy(agent_frames[id][page], (const void*)(*pte & ~(unsigned long)(PAGE_SIZE - 1)), PAGE_SIZE);
+    *pte = (unsigned long)agent_frames[id][page] | PAGE_PRESENT | PAGE_WRITE | PAGE_USER;
+    __asm__ volatile ("invlpg (%0)" : : "r"(addr) : "memory");
+    return 1;
+}
+
+int paging_switch(int agent_id) {
+    paging_space_t* space;
+    if (agent_id == PAGING_KERNEL_SPACE) {
+        space = &kernel_space;
+    } else if (agent_id >= 0 && agent_id < AGENT_MAX_COUNT) {
+        space = &agent_spaces[agent_id];
+    } else {
+        return -1;
+    }
+    
+    if (!paging_enabled || space == paging_current) {
+        return 0;
+    }
+    paging_load(space, 0);
+    return 0;
+}
+
+// Directory entry that maps PAGING_HUGE_VIEW in an agent's space
+static paging_entry_t* paging_huge_entry(int agent_id) {
+#if defined(__x86_64__)
+    return &agent_pd[agent_id][(PAGING_HUGE_VIEW >> PAGING_LARGE_SHIFT) & (PAGING_ENTRIES - 1)];
+#else
+    return &agent_root[agent_id][PAGING_HUGE_VIEW >> PAGING_LARGE_SHIFT];
+#endif
+}
+
+int paging_user_range_ok(unsigned long addr, unsigned long len) {
+    if (paging_current == 0 || paging_current == &kernel_space) {
+        return 0;
+    }
+    if (addr < PAGING_USER_BASE || addr + len < addr) {
+        return 0;
+    }
+    
+    // The huge view is a single directory entry
+    if (addr >= PAGING_HUGE_VIEW) {
+        paging_entry_t pde = *paging_huge_entry((int)(paging_current - agent_spaces));
+        return addr + len <= PAGING_HUGE_VIEW + PAGING_LARGE_PAGE_SIZE &&
+               (pde & (PAGE_PRESENT | PAGE_USER)) == (PAGE_PRESENT | PAGE_USER);
+    }
+    
+    // Every page touched must be a present user page in this agent's table
+    const paging_entry_t* pt = agent_pt[paging_current - agent_spaces];
+    unsigned long first = (addr - PAGING_USER_BASE) / PAGE_SIZE;
+    unsigned long last = len == 0 ? first : (addr + len - 1 - PAGING_USER_BASE) / PAGE_SIZE;
+    if (last >= PAGING_ENTRIES) {
+        return 0;
+    }
+    for (unsigned long i = first; i <= last; i++) {
+        if ((pt[i] & (PAGE_PRESENT | PAGE_USER)) != (PAGE_PRESENT | PAGE_USER)) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+// Page-table index range of [vaddr, vaddr + count pages) if it lies in the shared area
+static int paging_shared_slots(unsigned long vaddr, unsigned int count, unsigned int* first) {
+    if ((vaddr & (PAGE_SIZE - 1)) != 0 || vaddr < PAGING_SHARED_BASE) {
+        return -1;
+    }
+    unsigned long slot = (vaddr - PAGING_SHARED_BASE) / PAGE_SIZE;
+    if (count > PAGING_SHARED_PAGES || slot > PAGING_SHARED_PAGES - count) {
+        return -1;
+    }
+    *first = (unsigned int)((PAGING_SHARED_BASE - PAGING_USER_BASE) / PAGE_SIZE + slot);
+    return 0;
+}
+
+int paging_map_user(int agent_id, unsigned long vaddr, const void* pages, unsigned int count, int writable) {
+    unsigned int first;
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT || pages == 0 ||
+        paging_shared_slots(vaddr, count, &first) != 0) {
+        return -1;
+    }
+    
+    paging_entry_t* pt = agent_pt[agent_id];
+    for (unsigned int i = 0; i < count; i++) {
+        if (pt[first + i] & PAGE_PRESENT) {
+            return -1;
+        }
+    }
+    
+    // Not-present entries are never cached, so new mappings need no flush
+    paging_entry_t flags = PAGE_PRESENT | PAGE_USER | (writable ? PAGE_WRITE : 0);
+    for (unsigned int i = 0; i < count; i++) {
+        pt[first + i] = ((unsigned long)pages + i * PAGE_SIZE) | flags;
+    }
+    return 0;
+}
+
+int paging_unmap_user(int agent_id, unsigned long vaddr, unsigned int count) {
+    unsigned int first;
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT ||
+        paging_shared_slots(vaddr, count, &first) != 0) {
+        return -1;
+    }
+    
+    paging_space_t* space = &agent_spaces[agent_id];
+    paging_entry_t* pt = agent_pt[agent_id];
+    for (unsigned int i = 0; i < count; i++) {
+        if (!(pt[first + i] & PAGE_PRESENT)) {
+            continue;
+        }
+        pt[first + i] = 0;
+        if (space == paging_current) {
+            __asm__ volatile ("invlpg (%0)" : : "r"(vaddr + i * PAGE_SIZE) : "memory");
+        }
+    }
+    
+    // Another space's entries may still be cached under its PCID
+    if (space != paging_current) {
+        space->tlb_valid = 0;
+    }
+    return 0;
+}
+
+int paging_map_user_large(int agent_id, const void* page, int writable) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT || page == 0 ||
+        ((unsigned long)page & (PAGING_LARGE_PAGE_SIZE - 1)) != 0) {
+        return -1;
+    }
+    
+    paging_entry_t* pde = paging_huge_entry(agent_id);
+    if (*pde & PAGE_PRESENT) {
+        return -1;
+    }
+    *pde = (unsigned long)page | PAGE_PRESENT | PAGE_USER | PAGE_LARGE | (writable ? PAGE_WRITE : 0);
+    return 0;
+}
+
+int paging_unmap_user_large(int agent_id) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    
+    paging_entry_t* pde = paging_huge_entry(agent_id);
+    if (!(*pde & PAGE_PRESENT)) {
+        return 0;
+    }
+    *pde = 0;
+    
+    paging_space_t* space = &agent_spaces[agent_id];
+    if (space == paging_current) {
+        __asm__ volatile ("invlpg (%0)" : : "r"(PAGING_HUGE_VIEW) : "memory");
+    } else {
+        space->tlb_valid = 0;
+    }
+    return 0;
+}
+
+void* paging_window(int agent_id) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT) {
+        return 0;
+    }
+    return agent_frames[agent_id];
+}
+
+int paging_pcid_enabled(void) {
+    return paging_pcid;
+}
+
+// Benchmark working set: every window page plus a spread of kernel data
+#define PAGING_BENCH_ROUNDS 2000
+#define PAGING_BENCH_KERNEL_PAGES 16
+
+static unsigned char paging_bench_data[PAGING_BENCH_KERNEL_PAGES][PAGE_SIZE] PAGING_ALIGNED;
+static volatile unsigned long paging_bench_sink;
+
+static unsigned long paging_bench_touch(void) {
+    unsigned long sum = 0;
+    for (unsigned int i = 0; i < PAGING_AGENT_PAGES; i++) {
+        sum += *(volatile unsigned char*)(PAGING_AGENT_WINDOW + i * PAGE_SIZE);
+    }
+    for (unsigned int i = 0; i < PAGING_BENCH_KERNEL_PAGES; i++) {
+        sum += *(volatile unsigned char*)paging_bench_data[i];
+    }
+    return sum;
+}
+
+// Ping-pong between agent spaces 0 and 1; returns cycles per switch
+static unsigned int paging_bench_run(int full_flush) {
+    unsigned long sum = 0;
+    unsigned long long start = clock_cycles();
+    for (unsigned int r = 0; r < PAGING_BENCH_ROUNDS; r++) {
+        paging_load(&agent_spaces[r & 1], full_flush);
+        sum += paging_bench_touch();
+    }
+    unsigned long long cycles = clock_cycles() - start;
+    paging_bench_sink = sum;
+    return (unsigned int)clock_div64(cycles, PAGING_BENCH_ROUNDS);
+}
+
+void paging_bench(void) {
+    char line[96];
+    
+    if (!paging_enabled || AGENT_MAX_COUNT < 2) {
+        serial_write("BENCH paging_switch skipped (paging disabled)\n");
+        return;
+    }
+    
+    // Timer ticks would land in random iterations; measure with IRQs off
+    unsigned long flags = interrupts_save();
+    paging_bench_run(0);  // Warm up both PCIDs
+    unsigned int tagged = paging_bench_run(0);
+    unsigned int flushed = paging_bench_run(1);
+    paging_switch(PAGING_KERNEL_SPACE);
+    interrupts_restore(flags);
+    
+    // Lines: "BENCH <metric> <value> <unit>"
+    ksnprintf(line, sizeof(line), "BENCH paging_switch_tagged %u cycles\n", tagged);
+    serial_write(line);
+    ksnprintf(line, sizeof(line), "BENCH paging_switch_flush %u cycles\n", flushed);
+    serial_write(line);
+    ksnprintf(line, sizeof(line), "BENCH-INFO paging_switch global=%d pcid=%d\n",
+              paging_global, paging_pcid);
+    serial_write(line);
+}
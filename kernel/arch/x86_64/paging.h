@@ -0,0 +1,137 @@
+// AgentOS Paging and Per-Agent Address Spaces
+// Week 3: Shared global kernel identity map plus a ring-3 region per agent
+
+#ifndef ARCH_PAGING_H
+#define ARCH_PAGING_H
+
+#include "agent/agent.h"  // For AGENT_MAX_COUNT
+#include "idt.h"          // For interrupt_frame_t
+
+// Page size for the per-agent window (kernel identity map uses large pages)
+#define PAGE_SIZE 4096
+
+// Address space ID for the kernel (no agent window mapped)
+#define PAGING_KERNEL_SPACE -1
+
+// Private pages mapped into each agent's window
+#define PAGING_AGENT_PAGES 4
+
+// User region of every agent space, just above the 1 GiB kernel identity map
+// (below 2 GiB so x86_64 kernel code can still reference it directly), all
+// in one page table:
+//   PAGING_USER_BASE     ring-3 agent code and constants (the .user image), read-only
+//   PAGING_MODULE_VIEW   the agent's boot module (ELF object loaded by GRUB), read-only
+//   PAGING_AGENT_WINDOW  private read/write frames; the agent's stack is at the top
+//   PAGING_SHARED_BASE   kernel-granted mappings of shared pages (audit view, ...)
+// followed, in the next directory entry, by one shared large page:
+//   PAGING_HUGE_VIEW     kernel-granted large-page mapping (huge shared regions)
+#define PAGING_USER_BASE 0x40000000UL
+#define PAGING_USER_IMAGE_MAX (192 * PAGE_SIZE)
+#define PAGING_MODULE_VIEW (PAGING_USER_BASE + PAGING_USER_IMAGE_MAX)
+#define PAGING_MODULE_PAGES 64
+#define PAGING_AGENT_WINDOW (PAGING_MODULE_VIEW + PAGING_MODULE_PAGES * PAGE_SIZE)
+
+#define PAGING_AGENT_WINDOW_SIZE (PAGING_AGENT_PAGES * PAGE_SIZE)
+
+#define PAGING_SHARED_BASE (PAGING_AGENT_WINDOW + 16 * PAGE_SIZE)
+#define PAGING_SHARED_PAGES 240  // Up to the end of the page table on x86_64
+
+// Fixed slot in the shared area for the read-only audit view (AUDIT_VIEW_PAGES)
+#define PAGING_AUDIT_VIEW PAGING_SHARED_BASE
+#define PAGING_AUDIT_VIEW_PAGES 4
+
+// Agent-to-agent channel rings follow it (CHANNEL_VIEW() in channel/channel.h)
+#define PAGING_CHANNEL_BASE (PAGING_AUDIT_VIEW + PAGING_AUDIT_VIEW_PAGES * PAGE_SIZE)
+#define PAGING_CHANNEL_PAGES 64
+
+// Then shared memory regions (SHM_VIEW() in shm/shm.h), to the end of the area
+#define PAGING_REGION_BASE (PAGING_CHANNEL_BASE + PAGING_CHANNEL_PAGES * PAGE_SIZE)
+#define PAGING_REGION_PAGES (PAGING_SHARED_PAGES - PAGING_AUDIT_VIEW_PAGES - PAGING_CHANNEL_PAGES)
+
+// Large page size: 4 MiB (i386) / 2 MiB (x86_64)
+#if defined(__x86_64__)
+#define PAGING_LARGE_PAGE_SIZE 0x200000UL
+#else
+#define PAGING_LARGE_PAGE_SIZE 0x400000UL
+#endif
+
+// The directory entry after the user page table holds one large page
+#define PAGING_HUGE_VIEW (PAGING_USER_BASE + PAGING_LARGE_PAGE_SIZE)
+
+// Build the kernel identity map (global 4 MiB / 2 MiB pages, supervisor-only)
+// and one address space per agent slot, then switch to the kernel space
+// i386 enables paging here; x86_64 replaces the boot tables from entry64.S
+// and enables PCID when the CPU supports it
+// Returns: 0 on success, -1 if the CPU lacks large pages (kernel stays on
+// the boot mapping and paging_switch() becomes a no-op)
+int paging_init(void);
+
+// Clear an agent's private window and shared mappings for a newly created agent
+// Its cached translations are dropped on the next switch into it
+// Returns: 0 on success, -1 on invalid ID
+int paging_space_reset(int agent_id);
+
+// Like paging_space_reset(), but the window starts as a copy of image
+// (PAGING_AGENT_PAGES page-aligned pages) without copying anything: the
+// image pages are mapped read-only and copy-on-write, and a page is copied
+// into the agent's own frame on the first write to it (paging_cow_fault())
+// The image must not change while clones of it may still run
+// Returns: 0 on success, -1 on failure (invalid ID or misaligned image)
+int paging_space_clone(int agent_id, const void* image);
+
+// Map a boot module's pages (identity-mapped, page-aligned, at most
+// PAGING_MODULE_PAGES) read-only at PAGING_MODULE_VIEW in an agent's space,
+// replacing any previous module; paging_space_reset() and
+// paging_space_clone() remove it
+// Returns: 0 on success, -1 on invalid ID, alignment, size or address
+int paging_map_module(int agent_id, const void* image, unsigned int pages);
+
+// Resolve a page fault on a copy-on-write window page of the running agent
+// (called by interrupt_dispatch() for every page fault, ring 0 or 3)
+// Returns: 1 if the faulting write can be retried, 0 if the fault is real
+int paging_cow_fault(interrupt_frame_t* frame);
+
+// Switch to an agent's address space (or PAGING_KERNEL_SPACE)
+// Kernel translations are global and survive; with PCID the agent's own
+// translations survive too, so switching back does not refill the TLB
+// Returns: 0 on success, -1 on invalid ID
+int paging_switch(int agent_id);
+
+// Check that [addr, addr + len) is mapped for ring 3 in the current agent
+// space (any user page: image, window, shared area or huge view); used to
+// validate syscall pointers
+// Returns: 1 if valid, 0 otherwise (also when the kernel space is loaded)
+int paging_user_range_ok(unsigned long addr, unsigned long len);
+
+// Map physically contiguous kernel pages at vaddr in the shared area of an
+// agent's space (read-only unless writable); the slots must be unmapped
+// Returns: 0 on success, -1 on invalid ID, range outside the shared area or
+// slot already in use
+int paging_map_user(int agent_id, unsigned long vaddr, const void* pages, unsigned int count, int writable);
+
+// Remove mappings from an agent's shared area (unmapped slots are skipped);
+// stale translations are flushed before the agent can use them again
+// Returns: 0 on success, -1 on invalid ID or range outside the shared area
+int paging_unmap_user(int agent_id, unsigned long vaddr, unsigned int count);
+
+// Map one PAGING_LARGE_PAGE_SIZE-aligned kernel large page at
+// PAGING_HUGE_VIEW in an agent's space (read-only unless writable)
+// Returns: 0 on success, -1 on invalid ID or alignment, or slot already in use
+int paging_map_user_large(int agent_id, const void* page, int writable);
+
+// Remove the PAGING_HUGE_VIEW mapping from an agent's space (if any)
+// Returns: 0 on success, -1 on invalid ID
+int paging_unmap_user_large(int agent_id);
+
+// Kernel pointer to an agent's window (valid in every address space)
+// Returns: pointer to PAGING_AGENT_WINDOW_SIZE bytes, or 0 on invalid ID
+void* paging_window(int agent_id);
+
+// Check whether agent spaces are PCID-tagged (x86_64 with CPU support)
+int paging_pcid_enabled(void);
+
+// Microbenchmark: agent-to-agent switch cost with tagged/global TLB entries
+// versus a full TLB flush per switch; results are written to serial
+void paging_bench(void);
+
+#endif // ARCH_PAGING_H
@@ -0,0 +1,63 @@
+// AgentOS 8259A Programmable Interrupt Controller Implementation
+// Week 3: Legacy PIC remapping, masking and end-of-interrupt
+
+#include "pic.h"
+#include "io.h"
+
+// PIC I/O ports
+#define PIC1_COMMAND 0x20
+#define PIC1_DATA    0x21
+#define PIC2_COMMAND 0xA0
+#define PIC2_DATA    0xA1
+
+// PIC commands
+#define PIC_ICW1_INIT 0x11  // Initialization, ICW4 needed
+#define PIC_ICW4_8086 0x01  // 8086/88 mode
+#define PIC_EOI       0x20  // Non-specific end of interrupt
+
+void pic_init(void) {
+    // ICW1: start initialization sequence on both PICs
+    outb(PIC1_COMMAND, PIC_ICW1_INIT);
+    outb(PIC2_COMMAND, PIC_ICW1_INIT);
+    
+    // ICW2: vector offsets
+    outb(PIC1_DATA, PIC_IRQ_BASE);
+    outb(PIC2_DATA, PIC_IRQ_BASE + 8);
+    
+    // ICW3: slave on IRQ2, slave cascade identity 2
+    outb(PIC1_DATA, 0x04);
+    outb(PIC2_DATA, 0x02);
+    
+    // ICW4: 8086 mode
+    outb(PIC1_DATA, PIC_ICW4_8086);
+    outb(PIC2_DATA, PIC_ICW4_8086);
+    
+    // Mask everything except the cascade line; drivers unmask what they own
+    outb(PIC1_DATA, 0xFB);
+    outb(PIC2_DATA, 0xFF);
+}
+
+void pic_unmask(unsigned int irq) {
+    if (irq >= PIC_IRQ_COUNT) {
+        return;
+    }
+    unsigned short port = irq < 8 ? PIC1_DATA : PIC2_DATA;
+    unsigned char mask = inb(port) & (unsigned char)~(1U << (irq & 7));
+    outb(port, mask);
+}
+
+void pic_mask(unsigned int irq) {
+    if (irq >= PIC_IRQ_COUNT) {
+        return;
+    }
+    unsigned short port = irq < 8 ? PIC1_DATA : PIC2_DATA;
+    unsigned char mask = inb(port) | (unsigned char)(1U << (irq & 7));
+    outb(port, mask);
+}
+
+void pic_eoi(unsigned int irq) {
+    if (irq >= 8) {
+        outb(PIC2_COMMAND, PIC_EOI);
+    }
+    outb(PIC1_COMMAND, PIC_EOI);
+}
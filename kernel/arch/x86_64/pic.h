@@ -0,0 +1,23 @@
+// AgentOS 8259A Programmable Interrupt Controller
+// Week 3: Legacy PIC remapping, masking and end-of-interrupt
+
+#ifndef ARCH_PIC_H
+#define ARCH_PIC_H
+
+// Interrupt vectors the PIC IRQs are remapped to (clear of CPU exceptions)
+#define PIC_IRQ_BASE 32
+#define PIC_IRQ_COUNT 16
+
+// Remap both PICs to PIC_IRQ_BASE and mask every IRQ line
+void pic_init(void);
+
+// Unmask (enable) a single IRQ line (0-15)
+void pic_unmask(unsigned int irq);
+
+// Mask (disable) a single IRQ line (0-15)
+void pic_mask(unsigned int irq);
+
+// Acknowledge an IRQ (0-15)
+void pic_eoi(unsigned int irq);
+
+#endif // ARCH_PIC_H
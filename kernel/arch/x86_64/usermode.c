@@ -0,0 +1,93 @@
+// AgentOS User Mode Implementation
+// Week 3: Ring-3 agent execution with a sysenter/syscall fast system call path
+
+#include "usermode.h"
+#include "gdt.h"
+#include "io.h"
+#include "paging.h"
+#include "audit/audit.h"
+#include "lib/format.h"
+
+// Fast system call MSRs
+#define MSR_SYSENTER_CS  0x174
+#define MSR_SYSENTER_ESP 0x175
+#define MSR_SYSENTER_EIP 0x176
+#define MSR_EFER         0xC0000080
+#define MSR_STAR         0xC0000081
+#define MSR_LSTAR        0xC0000082
+#define MSR_FMASK        0xC0000084
+
+#define EFER_SCE 0x1               // syscall/sysret enable
+
+// RFLAGS bits cleared on syscall entry: IF (stack not switched yet), DF
+#define SYSCALL_FMASK 0x600
+
+// CPUID leaf 1 EDX: sysenter/sysexit present
+#define CPUID_EDX_SEP (1u << 11)
+
+// Entry code (usermode.S / usermode64.S)
+extern long user_enter(unsigned long entry, unsigned long context, unsigned long user_sp);
+extern void user_leave(long code) __attribute__((noreturn));
+extern char fast_syscall_entry[];
+
+static int usermode_ready = 0;
+
+int usermode_init(void) {
+#if defined(__x86_64__)
+    // sysret derives user SS/CS from STAR[63:48] + 8 / + 16
+    unsigned long long star = ((unsigned long long)((GDT_USER_DATA & ~3) - 8) << 48) |
+                              ((unsigned long long)GDT_KERNEL_CODE << 32);
+    wrmsr(MSR_STAR, star);
+    wrmsr(MSR_LSTAR, (unsigned long)fast_syscall_entry);
+    wrmsr(MSR_FMASK, SYSCALL_FMASK);
+    wrmsr(MSR_EFER, rdmsr(MSR_EFER) | EFER_SCE);
+#else
+    unsigned int eax, ebx, ecx, edx;
+    cpuid(1, &eax, &ebx, &ecx, &edx);
+    if (!(edx & CPUID_EDX_SEP)) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "User mode disabled: CPU lacks sysenter");
+        return -1;
+    }
+    // sysenter loads SS from SYSENTER_CS + 8; sysexit uses + 16 / + 24 for user CS/SS
+    wrmsr(MSR_SYSENTER_CS, GDT_KERNEL_CODE);
+    wrmsr(MSR_SYSENTER_EIP, (unsigned long)fast_syscall_entry);
+#endif
+    usermode_ready = 1;
+    return 0;
+}
+
+void usermode_set_kernel_stack(unsigned long sp) {
+    gdt_set_kernel_stack(sp);
+#if !defined(__x86_64__)
+    // x86_64's syscall entry switches to the same stack itself
+    wrmsr(MSR_SYSENTER_ESP, sp);
+#endif
+}
+
+long usermode_run(agent_entry_t entry, void* context) {
+    if (!usermode_ready) {
+        return USERMODE_EXIT_FAULT;
+    }
+    
+    // Ring 3 can only execute the .user image; anything else would fault on
+    // its first instruction
+    if (!paging_user_range_ok((unsigned long)entry, 1)) {
+        audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_DENY, agent_current(), -1, "Agent entry is not user code");
+        return USERMODE_EXIT_FAULT;
+    }
+    
+    return user_enter((unsigned long)entry, (unsigned long)context,
+                      PAGING_AGENT_WINDOW + PAGING_AGENT_WINDOW_SIZE);
+}
+
+void usermode_exit(long code) {
+    user_leave(code);
+}
+
+void usermode_fault(interrupt_frame_t* frame, const char* reason) {
+    char audit_msg[AUDIT_MSG_MAX];
+    ksnprintf(audit_msg, sizeof(audit_msg), "Agent fault: %s at pc=0x%08lx err=0x%08lx", reason,
+              (unsigned long)INTERRUPT_FRAME_PC(frame), (unsigned long)frame->error_code);
+    audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, agent_current(), -1, audit_msg);
+    user_leave(USERMODE_EXIT_FAULT);
+}
@@ -0,0 +1,39 @@
+// AgentOS User Mode
+// Week 3: Ring-3 agent execution with a sysenter/syscall fast system call path
+
+#ifndef ARCH_USERMODE_H
+#define ARCH_USERMODE_H
+
+#include "idt.h"
+#include "agent/agent.h"  // For agent_entry_t
+
+// Exit code of an agent terminated by a CPU exception (or refused entry)
+#define USERMODE_EXIT_FAULT -1
+
+// Exit code of an agent stopped for using up its CPU budget
+#define USERMODE_EXIT_BUDGET -2
+
+// Program the fast system call MSRs (SYSENTER_* on i386; EFER.SCE, STAR,
+// LSTAR and FMASK on x86_64)
+// Returns: 0 on success, -1 if the CPU lacks sysenter (agents cannot run)
+int usermode_init(void);
+
+// Run entry(context) in ring 3 in the current address space, on a stack at
+// the top of the agent window; entry must be USER_TEXT (see kernel/user/user.h)
+// Returns when the agent returns, exits, or faults
+// Returns: the agent's exit code, USERMODE_EXIT_FAULT if it faulted or could not start
+long usermode_run(agent_entry_t entry, void* context);
+
+// End the running agent and resume usermode_run() with the given exit code
+// Called from the system call layer (SYS_NR_EXIT), or from an interrupt
+// handler that stops the agent (the IRQ must already be acknowledged)
+void usermode_exit(long code) __attribute__((noreturn));
+
+// Terminate the running agent after a CPU exception in ring 3 (audited)
+void usermode_fault(interrupt_frame_t* frame, const char* reason) __attribute__((noreturn));
+
+// Set the ring-0 stack used for traps and fast system calls from ring 3
+// (called by the entry code each time an agent starts)
+void usermode_set_kernel_stack(unsigned long sp);
+
+#endif // ARCH_USERMODE_H
@@ -0,0 +1,181 @@
+// AgentOS ATA Disk Driver Implementation
+// Week 3: Polled PIO access to the primary ATA disk (snapshot storage)
+
+#include "ata.h"
+#include "arch/x86_64/io.h"
+
+// Primary bus I/O ports
+#define ATA_DATA       0x1F0
+#define ATA_ERROR      0x1F1
+#define ATA_COUNT      0x1F2
+#define ATA_LBA_LOW    0x1F3
+#define ATA_LBA_MID    0x1F4
+#define ATA_LBA_HIGH   0x1F5
+#define ATA_DRIVE      0x1F6
+#define ATA_COMMAND    0x1F7  // Status on read
+#define ATA_CONTROL    0x3F6  // Alternate status on read
+
+// Status bits
+#define ATA_STATUS_ERR 0x01
+#define ATA_STATUS_DRQ 0x08
+#define ATA_STATUS_DF  0x20
+#define ATA_STATUS_BSY 0x80
+
+// Commands
+#define ATA_CMD_READ     0x20
+#define ATA_CMD_WRITE    0x30
+#define ATA_CMD_FLUSH    0xE7
+#define ATA_CMD_IDENTIFY 0xEC
+
+// Drive register: master, LBA addressing (low nibble = LBA bits 24-27)
+#define ATA_DRIVE_MASTER_LBA 0xE0
+
+// Control register: no interrupts from the drive
+#define ATA_CONTROL_NIEN 0x02
+
+// LBA28 commands move at most 256 sectors (count register 0)
+#define ATA_MAX_TRANSFER 256
+
+// Status polls before giving up (a missing or wedged drive must not hang boot)
+#define ATA_POLL_LIMIT 1000000
+
+static int ata_present = 0;
+static unsigned int ata_capacity = 0;
+
+// 400 ns settle time after selecting a drive: four alternate-status reads
+static void ata_delay(void) {
+    for (int i = 0; i < 4; i++) {
+        inb(ATA_CONTROL);
+    }
+}
+
+// Wait for BSY to clear, then for DRQ if data is expected
+// Returns: 0 when ready, -1 on error, drive fault or timeout
+static int ata_wait(int want_drq) {
+    for (unsigned int i = 0; i < ATA_POLL_LIMIT; i++) {
+        unsigned char status = inb(ATA_COMMAND);
+        if (status & ATA_STATUS_BSY) {
+            continue;
+        }
+        if (status & (ATA_STATUS_ERR | ATA_STATUS_DF)) {
+            return -1;
+        }
+        if (!want_drq || (status & ATA_STATUS_DRQ)) {
+            return 0;
+        }
+    }
+    return -1;
+}
+
+// Select the master with the top LBA bits and issue a transfer command
+static void ata_command(unsigned int lba, unsigned int count, unsigned char command) {
+    outb(ATA_DRIVE, (unsigned char)(ATA_DRIVE_MASTER_LBA | ((lba >> 24) & 0x0F)));
+    ata_delay();
+    outb(ATA_COUNT, (unsigned char)(count == ATA_MAX_TRANSFER ? 0 : count));
+    outb(ATA_LBA_LOW, (unsigned char)lba);
+    outb(ATA_LBA_MID, (unsigned char)(lba >> 8));
+    outb(ATA_LBA_HIGH, (unsigned char)(lba >> 16));
+    outb(ATA_COMMAND, command);
+}
+
+int ata_init(void) {
+    ata_present = 0;
+    ata_capacity = 0;
+    
+    // A floating bus reads 0xFF: no controller
+    if (inb(ATA_COMMAND) == 0xFF) {
+        return -1;
+    }
+    outb(ATA_CONTROL, ATA_CONTROL_NIEN);
+    
+    outb(ATA_DRIVE, ATA_DRIVE_MASTER_LBA);
+    ata_delay();
+    outb(ATA_COUNT, 0);
+    outb(ATA_LBA_LOW, 0);
+    outb(ATA_LBA_MID, 0);
+    outb(ATA_LBA_HIGH, 0);
+    outb(ATA_COMMAND, ATA_CMD_IDENTIFY);
+    if (inb(ATA_COMMAND) == 0) {
+        return -1;
+    }
+    
+    // ATAPI and SATA devices abort IDENTIFY with a signature in LBA mid/high
+    for (unsigned int i = 0; i < ATA_POLL_LIMIT && (inb(ATA_COMMAND) & ATA_STATUS_BSY); i++) {
+    }
+    if (inb(ATA_LBA_MID) != 0 || inb(ATA_LBA_HIGH) != 0 || ata_wait(1) != 0) {
+        return -1;
+    }
+    
+    // Words 60-61: sectors addressable with LBA28
+    unsigned short identify[ATA_SECTOR_SIZE / 2];
+    for (unsigned int i = 0; i < ATA_SECTOR_SIZE / 2; i++) {
+        identify[i] = inw(ATA_DATA);
+    }
+    ata_capacity = identify[60] | ((unsigned int)identify[61] << 16);
+    if (ata_capacity == 0) {
+        return -1;
+    }
+    ata_present = 1;
+    return 0;
+}
+
+unsigned int ata_sectors(void) {
+    return ata_capacity;
+}
+
+// Check a request against the disk
+static int ata_range_ok(unsigned int lba, unsigned int count, const void* buf) {
+    return ata_present && buf != 0 && count != 0 && lba < ata_capacity && count <= ata_capacity - lba;
+}
+
+int ata_read(unsigned int lba, unsigned int count, void* buf) {
+    if (!ata_range_ok(lba, count, buf)) {
+        return -1;
+    }
+    
+    unsigned short* words = (unsigned short*)buf;
+    while (count > 0) {
+        unsigned int chunk = count < ATA_MAX_TRANSFER ? count : ATA_MAX_TRANSFER;
+        ata_command(lba, chunk, ATA_CMD_READ);
+        for (unsigned int s = 0; s < chunk; s++) {
+            if (ata_wait(1) != 0) {
+                return -1;
+            }
+            for (unsigned int i = 0; i < ATA_SECTOR_SIZE / 2; i++) {
+                *words++ = inw(ATA_DATA);
+            }
+        }
+        lba += chunk;
+        count -= chunk;
+    }
+    return 0;
+}
+
+int ata_write(unsigned int lba, unsigned int count, const void* buf) {
+    if (!ata_range_ok(lba, count, buf)) {
+        return -1;
+    }
+    
+    const unsigned short* words = (const unsigned short*)buf;
+    while (count > 0) {
+        unsigned int chunk = count < ATA_MAX_TRANSFER ? count : ATA_MAX_TRANSFER;
+        ata_command(lba, chunk, ATA_CMD_WRITE);
+        for (unsigned int s = 0; s < chunk; s++) {
+            if (ata_wait(1) != 0) {
+                return -1;
+            }
+            for (unsigned int i = 0; i < ATA_SECTOR_SIZE / 2; i++) {
+                outw(ATA_DATA, *words++);
+            }
+        }
+        lba += chunk;
+        count -= chunk;
+    }
+    
+    // The last sector must be taken before the cache flush is issued
+    if (ata_wait(0) != 0) {
+        return -1;
+    }
+    outb(ATA_COMMAND, ATA_CMD_FLUSH);
+    return ata_wait(0);
+}
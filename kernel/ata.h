@@ -0,0 +1,28 @@
+// AgentOS ATA Disk Driver
+// Week 3: Polled PIO access to the primary ATA disk (snapshot storage)
+
+#ifndef ATA_H
+#define ATA_H
+
+// Bytes per sector
+#define ATA_SECTOR_SIZE 512
+
+// Probe the primary master with IDENTIFY (LBA28 ATA disks only; ATAPI and
+// empty buses are ignored) and mask its interrupt, since transfers are polled
+// Returns: 0 if a disk is present, -1 otherwise
+int ata_init(void);
+
+// Capacity of the disk in sectors (0 if none)
+unsigned int ata_sectors(void);
+
+// Read count sectors starting at lba into buf (count * ATA_SECTOR_SIZE bytes)
+// Busy-waits on the drive; must not be called from an interrupt handler
+// Returns: 0 on success, -1 on no disk, out-of-range request, drive error or timeout
+int ata_read(unsigned int lba, unsigned int count, void* buf);
+
+// Write count sectors starting at lba from buf, then flush the drive's
+// write cache so the data is on the medium when this returns
+// Returns: 0 on success, -1 on no disk, out-of-range request, drive error or timeout
+int ata_write(unsigned int lba, unsigned int count, const void* buf);
+
+#endif // ATA_H
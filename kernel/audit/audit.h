@@ -9,12 +9,16 @@
 // INTENT_MAX or -1 indicates "not applicable"
 typedef int audit_intent_action_t;
 
-// Maximum number of audit events in ring buffer
+// Maximum number of audit events in ring buffer (audit_events= on the
+// kernel command line may use fewer)
 #define AUDIT_MAX_EVENTS 64
 
 // Maximum audit message length (including null terminator)
 #define AUDIT_MSG_MAX 128
 
+// Times audit_bench() fills the whole ring
+#define AUDIT_BENCH_WRAPS 4
+
 // Agent ID type (matches agent module)
 typedef int agent_id_t;
 
@@ -38,6 +42,7 @@ typedef enum {
     AUDIT_RESULT_DENY,           // Capability denied
     AUDIT_RESULT_SUCCESS,        // Operation succeeded
     AUDIT_RESULT_FAILURE,        // Operation failed
+    AUDIT_RESULT_THROTTLE,       // Rejected by rate limit / quota
     AUDIT_RESULT_MAX             // Sentinel value
 } audit_result_t;
 
@@ -48,9 +53,36 @@ typedef struct {
     agent_id_t agent_id;         // Agent ID (-1 for system events)
     audit_intent_action_t intent_action; // Optional intent action (-1 or INTENT_MAX if not applicable)
     unsigned int sequence;       // Sequence counter for chronological ordering
+    unsigned long long timestamp; // TSC cycles at emission (converted to time only when displayed)
     char message[AUDIT_MSG_MAX]; // Fixed-size message buffer (null-terminated)
 } audit_event_t;
 
+// Read-only view of the ring, mapped at PAGING_AUDIT_VIEW into agents holding
+// CAP_AUDIT_READ. Readers follow the seqlock protocol with plain loads:
+//   1. s = seq; retry while s is odd (a record is being written)
+//   2. read write_pos / total_count / events
+//   3. retry if seq != s
+// The event with sequence n lives at events[n % capacity] while
+// total_count - n <= capacity. After a warm boot, events below boot_seq
+// were written by an earlier boot: their TSC timestamps do not compare
+// with this boot's
+typedef struct {
+    volatile unsigned int seq;          // Incremented before and after every write (odd while writing)
+    volatile unsigned int write_pos;    // Next slot to be written
+    volatile unsigned int total_count;  // Events emitted so far (sequence of the next event)
+    unsigned int capacity;              // Ring slots in use (audit_events= tunable, <= AUDIT_MAX_EVENTS)
+    unsigned int boot_seq;              // Sequence of this boot's first event (older ones came from a snapshot)
+    unsigned int reserved[11];          // Pads the header to 64 bytes
+} audit_view_header_t;
+
+typedef struct {
+    audit_view_header_t header;
+    audit_event_t events[AUDIT_MAX_EVENTS];
+} audit_view_t;
+
+// Pages occupied by the view (page-aligned, shared with no other kernel data)
+#define AUDIT_VIEW_PAGES 3
+
 // Initialize the audit system
 void audit_init(void);
 
@@ -64,7 +96,18 @@ void audit_init(void);
 // Returns: 0 on success, -1 on failure (buffer full or invalid args)
 int audit_emit(audit_type_t type, audit_result_t result, agent_id_t agent_id, audit_intent_action_t intent_action, const char* message);
 
-// Dump all audit events to VGA console in chronological order (oldest→newest)
+// Dump all audit events to the kernel console in chronological order (oldest→newest)
+// Each event shows its time since boot; intent results also show the
+// submit-to-complete latency of the intent they close. Events restored from
+// a snapshot are marked as from an earlier boot instead
 void audit_dump_to_console(void);
 
+// Kernel address of the view (AUDIT_VIEW_PAGES physically contiguous pages)
+const audit_view_t* audit_view(void);
+
+// Microbenchmark: per-record cost of audit_emit() while the ring wraps
+// (AUDIT_BENCH_WRAPS times over); result is written to serial. Overwrites
+// every record kept so far, so run it after anything that reads the log
+void audit_bench(void);
+
 #endif // AUDIT_H
@@ -3,121 +3,208 @@
 
 #include "cap.h"
 #include "audit/audit.h"
+#include "intent/intent.h"  // For intent_action_to_capability()
+#include "snapshot/snapshot.h"
+#include "lib/format.h"
 
-// Capability bitmask for each agent (fixed-size array, no heap)
-static cap_mask_t agent_caps[AGENT_MAX_COUNT];
+// Parent value for grants made directly by the kernel (delegation tree roots)
+#define CAP_PARENT_KERNEL -1
+
+// Delegation tree node: one per (capability bit, agent)
+// A grant is valid while it is live and every ancestor up to a kernel grant
+// still has the generation observed when the delegation was made.
+typedef struct {
+    int parent;                      // Delegating agent ID, or CAP_PARENT_KERNEL
+    unsigned int parent_generation;  // Parent generation at delegation time
+    unsigned int generation;         // Bumped on revoke to invalidate children
+    unsigned int depth;              // Delegation depth (0 = kernel grant)
+    int live;                        // 1 while this agent holds the grant
+} cap_node_t;
+
+// Capability state, kept in one structure so it is one snapshot section
+static struct {
+    // Delegation trees, stored per capability bit (fixed-size array, no heap)
+    cap_node_t tree[CAP_BIT_COUNT][AGENT_MAX_COUNT];
+    
+    // Bits with a live node for each agent (may include stale delegated grants)
+    cap_mask_t held[AGENT_MAX_COUNT];
+    
+    // Effective capability bitmask for each agent, cached at agent_caps_epoch
+    cap_mask_t caps[AGENT_MAX_COUNT];
+    
+    // Revocation epoch each cached mask was computed at
+    unsigned int caps_epoch[AGENT_MAX_COUNT];
+    
+    // Global revocation epoch (incremented on every revoke)
+    unsigned int epoch;
+    
+    // Rights on shared memory regions, per agent
+    unsigned char region_table[AGENT_MAX_COUNT][CAP_REGION_MAX];
+} cap_state;
+
+#define cap_tree (cap_state.tree)
+#define agent_caps_held (cap_state.held)
+#define agent_caps (cap_state.caps)
+#define agent_caps_epoch (cap_state.caps_epoch)
+#define cap_epoch (cap_state.epoch)
+#define cap_region_table (cap_state.region_table)
+
+// Record a change to part of cap_state for the next checkpoint
+#define cap_dirty(field) snapshot_dirty(SNAPSHOT_SECTION_CAPS, &(field), sizeof(field))
 
 // Initialization flag
 static int cap_initialized = 0;
 
-// Helper function to get string length (no libc)
-static unsigned int str_len(const char* s) {
-    unsigned int len = 0;
-    while (s[len] != '\0') {
-        len++;
-    }
-    return len;
-}
-
 // Convert capability mask to string representation (for audit)
 static void cap_mask_to_string(cap_mask_t mask, char* buffer, unsigned int buffer_size) {
     if (buffer_size == 0) {
         return;
     }
     
-    unsigned int pos = 0;
-    
     if (mask == CAP_NONE) {
-        // Copy "NONE"
-        const char* none_str = "NONE";
-        unsigned int none_len = str_len(none_str);
-        for (unsigned int i = 0; i < none_len && pos < buffer_size - 1; i++) {
-            buffer[pos++] = none_str[i];
-        }
-        buffer[pos] = '\0';
+        ksnprintf(buffer, buffer_size, "NONE");
         return;
     }
     
     // Build capability string by checking each bit
-    unsigned int first = 1;
+    unsigned int pos = 0;
+    buffer[0] = '\0';
     
     if (mask & CAP_CONSOLE_WRITE) {
-        if (!first && pos < buffer_size - 1) {
-            buffer[pos++] = '|';
-        }
-        first = 0;
-        const char* console_str = "CONSOLE_WRITE";
-        unsigned int console_len = str_len(console_str);
-        for (unsigned int i = 0; i < console_len && pos < buffer_size - 1; i++) {
-            buffer[pos++] = console_str[i];
-        }
+        pos += ksnprintf(buffer + pos, buffer_size - pos, "%sCONSOLE_WRITE", pos == 0 ? "" : "|");
+    }
+    
+    if (mask & CAP_PROFILE) {
+        pos += ksnprintf(buffer + pos, buffer_size - pos, "%sPROFILE", pos == 0 ? "" : "|");
+    }
+    
+    if (mask & CAP_CONSOLE_CONTROL) {
+        pos += ksnprintf(buffer + pos, buffer_size - pos, "%sCONSOLE_CONTROL", pos == 0 ? "" : "|");
+    }
+    
+    if (mask & CAP_AUDIT_READ) {
+        pos += ksnprintf(buffer + pos, buffer_size - pos, "%sAUDIT_READ", pos == 0 ? "" : "|");
+    }
+    
+    if (mask & CAP_CHANNEL) {
+        pos += ksnprintf(buffer + pos, buffer_size - pos, "%sCHANNEL", pos == 0 ? "" : "|");
+    }
+    
+    if (mask & CAP_SHM) {
+        pos += ksnprintf(buffer + pos, buffer_size - pos, "%sSHM", pos == 0 ? "" : "|");
+    }
+    
+    if (mask & CAP_TIMER) {
+        pos += ksnprintf(buffer + pos, buffer_size - pos, "%sTIMER", pos == 0 ? "" : "|");
+    }
+    
+    if (mask & CAP_CONSOLE_READ) {
+        pos += ksnprintf(buffer + pos, buffer_size - pos, "%sCONSOLE_READ", pos == 0 ? "" : "|");
     }
     
     // Future capabilities can be added here
     // if (mask & CAP_SOME_OTHER) { ... }
-    
-    buffer[pos] = '\0';
 }
 
-// Convert integer to string (no libc, for agent_id)
-static void int_to_string(int value, char* buffer, unsigned int buffer_size) {
-    if (buffer_size == 0) {
-        return;
+// Check whether an agent's grant for one capability bit is still valid
+// Walks toward the kernel grant at the root; bounded by CAP_DELEGATION_DEPTH_MAX
+static int cap_node_valid(unsigned int bit, agent_id_t agent_id) {
+    const cap_node_t* node = &cap_tree[bit][agent_id];
+    for (unsigned int hops = 0; hops <= CAP_DELEGATION_DEPTH_MAX; hops++) {
+        if (!node->live) {
+            return 0;
+        }
+        if (node->parent == CAP_PARENT_KERNEL) {
+            return 1;
+        }
+        const cap_node_t* parent = &cap_tree[bit][node->parent];
+        if (parent->generation != node->parent_generation) {
+            // Parent was revoked (or re-granted) after delegating to us
+            return 0;
+        }
+        node = parent;
     }
+    return 0;
+}
+
+// Drop a grant and invalidate everything delegated from it
+static void cap_node_drop(unsigned int bit, agent_id_t agent_id) {
+    cap_node_t* node = &cap_tree[bit][agent_id];
+    node->live = 0;
+    node->generation++;
+    agent_caps_held[agent_id] &= ~(1U << bit);
+    cap_dirty(*node);
+    cap_dirty(agent_caps_held[agent_id]);
+}
+
+// Recompute an agent's effective mask after a revocation epoch change
+// Stale delegated grants are detected here, lazily, instead of at revoke time
+static void cap_refresh(agent_id_t agent_id) {
+    cap_mask_t held = agent_caps_held[agent_id];
+    cap_mask_t effective = CAP_NONE;
     
-    unsigned int pos = 0;
-    unsigned int abs_value;
-    
-    // Handle negative sign
-    if (value < 0) {
-        if (pos >= buffer_size - 1) {
-            buffer[0] = '\0';
-            return;
+    for (unsigned int bit = 0; bit < CAP_BIT_COUNT; bit++) {
+        if (!(held & (1U << bit))) {
+            continue;
         }
-        buffer[pos++] = '-';
-        // Convert to unsigned for arithmetic (avoid overflow issues)
-        if (value == -2147483647 - 1) {
-            // Handle INT_MIN specially
-            abs_value = 2147483648U;
+        if (cap_node_valid(bit, agent_id)) {
+            effective |= 1U << bit;
         } else {
-            abs_value = (unsigned int)(-value);
-        }
-    } else {
-        abs_value = (unsigned int)value;
-    }
-    
-    // Convert to string (reverse order first)
-    char temp[16];
-    unsigned int temp_pos = 0;
-    if (abs_value == 0) {
-        temp[temp_pos++] = '0';
-    } else {
-        while (abs_value > 0 && temp_pos < 15) {
-            temp[temp_pos++] = '0' + (abs_value % 10);
-            abs_value /= 10;
+            cap_node_drop(bit, agent_id);
         }
     }
     
-    // Reverse and copy to buffer
-    while (temp_pos > 0 && pos < buffer_size - 1) {
-        buffer[pos++] = temp[--temp_pos];
+    agent_caps[agent_id] = effective;
+    agent_caps_epoch[agent_id] = cap_epoch;
+    cap_dirty(agent_caps[agent_id]);
+    cap_dirty(agent_caps_epoch[agent_id]);
+}
+
+// Make an agent hold one capability bit with the given parent
+static void cap_node_set(unsigned int bit, agent_id_t agent_id, int parent, unsigned int depth) {
+    cap_node_t* node = &cap_tree[bit][agent_id];
+    
+    // A stale grant still hanging around must not keep its children alive
+    if (node->live && !cap_node_valid(bit, agent_id)) {
+        node->generation++;
     }
-    buffer[pos] = '\0';
+    
+    node->parent = parent;
+    node->parent_generation = parent == CAP_PARENT_KERNEL ? 0 : cap_tree[bit][parent].generation;
+    node->depth = depth;
+    node->live = 1;
+    agent_caps_held[agent_id] |= 1U << bit;
+    
+    // Keep the cached mask current; a stale cache is rebuilt on the next check anyway
+    if (agent_caps_epoch[agent_id] == cap_epoch) {
+        agent_caps[agent_id] |= 1U << bit;
+    }
+    cap_dirty(*node);
+    cap_dirty(agent_caps_held[agent_id]);
+    cap_dirty(agent_caps[agent_id]);
 }
 
 void cap_init(void) {
-    // Initialize all agent capabilities to CAP_NONE
+    // cap_state starts zeroed in BSS (every agent at CAP_NONE, no nodes
+    // live, no region rights); only the parent links need a non-zero value
     for (unsigned int i = 0; i < AGENT_MAX_COUNT; i++) {
-        agent_caps[i] = CAP_NONE;
+        for (unsigned int bit = 0; bit < CAP_BIT_COUNT; bit++) {
+            cap_tree[bit][i].parent = CAP_PARENT_KERNEL;
+        }
     }
     
     cap_initialized = 1;
+    snapshot_register(SNAPSHOT_SECTION_CAPS, &cap_state, sizeof(cap_state), 0);
     
     // Emit audit event for capability system initialization with structured record
     audit_emit(AUDIT_TYPE_SYSTEM_INIT, AUDIT_RESULT_NONE, -1, -1, "Capability system initialized");
 }
 
 int cap_grant(agent_id_t agent_id, cap_mask_t mask) {
+    return cap_grant_quota(agent_id, mask, 0);
+}
+
+int cap_grant_unaudited(agent_id_t agent_id, cap_mask_t mask, const quota_t* quota) {
     // Check if initialized
     if (!cap_initialized) {
         return -1;
@@ -128,45 +215,45 @@ int cap_grant(agent_id_t agent_id, cap_mask_t mask) {
         return -1;
     }
     
-    // Grant capabilities (OR with existing mask)
-    agent_caps[agent_id] |= mask;
+    // Grant capabilities as kernel grants (roots of the delegation trees)
+    // A live delegated grant is promoted in place so its children stay valid
+    for (unsigned int bit = 0; bit < CAP_BIT_COUNT; bit++) {
+        if (mask & (1U << bit)) {
+            cap_node_set(bit, agent_id, CAP_PARENT_KERNEL, 0);
+        }
+    }
     
-    // Emit audit event for capability grant
-    char audit_msg[128];
-    unsigned int pos = 0;
+    // Configure token buckets for the intent actions these capabilities unlock
+    if (quota != 0) {
+        for (int action = 0; action < INTENT_MAX; action++) {
+            cap_mask_t required = intent_action_to_capability((intent_action_t)action);
+            if (required != CAP_NONE && (required & mask) == required) {
+                quota_set(agent_id, action, quota);
+            }
+        }
+    }
     
-    // Build message: "Granted CAPS to agent ID"
-    const char* granted_str = "Granted ";
-    unsigned int granted_len = str_len(granted_str);
-    for (unsigned int i = 0; i < granted_len && pos < 127; i++) {
-        audit_msg[pos++] = granted_str[i];
+    return 0;
+}
+
+int cap_grant_quota(agent_id_t agent_id, cap_mask_t mask, const quota_t* quota) {
+    if (cap_grant_unaudited(agent_id, mask, quota) != 0) {
+        return -1;
     }
     
-    // Add capability mask string
+    // Emit audit event for capability grant
+    // Build message: "Granted CAPS to agent ID"
+    char audit_msg[128];
     char cap_str[64];
     cap_mask_to_string(mask, cap_str, 64);
-    unsigned int cap_len = str_len(cap_str);
-    for (unsigned int i = 0; i < cap_len && pos < 127; i++) {
-        audit_msg[pos++] = cap_str[i];
-    }
+    unsigned int pos = ksnprintf(audit_msg, 128, "Granted %s to agent %d", cap_str, agent_id);
     
-    // Add " to agent "
-    const char* to_agent_str = " to agent ";
-    unsigned int to_agent_len = str_len(to_agent_str);
-    for (unsigned int i = 0; i < to_agent_len && pos < 127; i++) {
-        audit_msg[pos++] = to_agent_str[i];
+    // Add " (quota R/s burst B)" when rate limited
+    if (quota != 0 && quota->rate != 0) {
+        ksnprintf(audit_msg + pos, 128 - pos, " (quota %u/s burst %u)",
+                  quota->rate, quota->burst == 0 ? 1 : quota->burst);
     }
     
-    // Add agent ID
-    char id_str[16];
-    int_to_string(agent_id, id_str, 16);
-    unsigned int id_len = str_len(id_str);
-    for (unsigned int i = 0; i < id_len && pos < 127; i++) {
-        audit_msg[pos++] = id_str[i];
-    }
-    
-    audit_msg[pos] = '\0';
-    
     // Emit capability grant event with structured record (SUCCESS result, no intent involved)
     audit_emit(AUDIT_TYPE_USER_ACTION, AUDIT_RESULT_SUCCESS, agent_id, -1, audit_msg);
     
@@ -184,7 +271,189 @@ int cap_has(agent_id_t agent_id, cap_mask_t mask) {
         return 0;
     }
     
+    // Rebuild the cached mask if a revocation happened since it was computed
+    if (agent_caps_epoch[agent_id] != cap_epoch) {
+        cap_refresh(agent_id);
+    }
+    
     // Check if agent has all required capabilities (all bits in mask must be set)
     // This checks: (agent_caps[agent_id] & mask) == mask
     return (agent_caps[agent_id] & mask) == mask;
 }
+
+int cap_revoke(agent_id_t agent_id, cap_mask_t mask) {
+    // Check if initialized
+    if (!cap_initialized) {
+        return -1;
+    }
+    
+    // Validate agent ID
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    
+    // Invalidate the agent's grants; delegated children are not walked here,
+    // they fail their parent generation check the next time they are used
+    for (unsigned int bit = 0; bit < CAP_BIT_COUNT; bit++) {
+        if ((mask & (1U << bit)) && cap_tree[bit][agent_id].live) {
+            cap_node_drop(bit, agent_id);
+        }
+    }
+    agent_caps[agent_id] &= ~mask;
+    
+    // Bump the epoch so every cached mask is revalidated on its next check
+    cap_epoch++;
+    cap_dirty(agent_caps[agent_id]);
+    cap_dirty(cap_epoch);
+    
+    // Build message: "Revoked CAPS from agent ID"
+    char audit_msg[128];
+    char cap_str[64];
+    cap_mask_to_string(mask, cap_str, 64);
+    ksnprintf(audit_msg, 128, "Revoked %s from agent %d", cap_str, agent_id);
+    
+    audit_emit(AUDIT_TYPE_USER_ACTION, AUDIT_RESULT_SUCCESS, agent_id, -1, audit_msg);
+    
+    return 0;
+}
+
+int cap_clear(agent_id_t agent_id) {
+    // Check if initialized
+    if (!cap_initialized) {
+        return -1;
+    }
+    
+    // Validate agent ID
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    
+    // Same invalidation as cap_revoke(), for every bit held
+    for (unsigned int bit = 0; bit < CAP_BIT_COUNT; bit++) {
+        if (cap_tree[bit][agent_id].live) {
+            cap_node_drop(bit, agent_id);
+        }
+    }
+    cap_epoch++;
+    agent_caps[agent_id] = CAP_NONE;
+    agent_caps_epoch[agent_id] = cap_epoch;
+    cap_dirty(agent_caps[agent_id]);
+    cap_dirty(agent_caps_epoch[agent_id]);
+    cap_dirty(cap_epoch);
+    
+    for (unsigned int region = 0; region < CAP_REGION_MAX; region++) {
+        cap_region_table[agent_id][region] = 0;
+    }
+    cap_dirty(cap_region_table[agent_id]);
+    
+    // Quotas come with grants (cap_grant_quota()), so they go with them
+    for (int action = 0; action < INTENT_MAX; action++) {
+        quota_set(agent_id, action, 0);
+    }
+    
+    return 0;
+}
+
+int cap_delegate(agent_id_t from_id, agent_id_t to_id, cap_mask_t mask) {
+    // Check if initialized
+    if (!cap_initialized) {
+        return -1;
+    }
+    
+    // Validate agent IDs
+    if (from_id < 0 || from_id >= AGENT_MAX_COUNT || to_id < 0 || to_id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    if (from_id == to_id || mask == CAP_NONE) {
+        return -1;
+    }
+    
+    // Build message: "Delegated CAPS from agent ID to agent ID"
+    char audit_msg[128];
+    char cap_str[64];
+    cap_mask_to_string(mask, cap_str, 64);
+    ksnprintf(audit_msg, 128, "Delegated %s from agent %d to agent %d", cap_str, from_id, to_id);
+    
+    // Delegator must currently hold every bit it hands out
+    if (!cap_has(from_id, mask)) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_DENY, from_id, -1, audit_msg);
+        return -1;
+    }
+    
+    // Check depth for every bit before changing anything
+    for (unsigned int bit = 0; bit < CAP_BIT_COUNT; bit++) {
+        if ((mask & (1U << bit)) && cap_tree[bit][from_id].depth >= CAP_DELEGATION_DEPTH_MAX) {
+            audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, from_id, -1, audit_msg);
+            return -1;
+        }
+    }
+    
+    // Attach new grants as children of the delegator's grants
+    // Bits the target already holds validly keep their existing parent (no cycles)
+    for (unsigned int bit = 0; bit < CAP_BIT_COUNT; bit++) {
+        if (!(mask & (1U << bit))) {
+            continue;
+        }
+        if (cap_tree[bit][to_id].live && cap_node_valid(bit, to_id)) {
+            continue;
+        }
+        cap_node_set(bit, to_id, from_id, cap_tree[bit][from_id].depth + 1);
+    }
+    
+    audit_emit(AUDIT_TYPE_USER_ACTION, AUDIT_RESULT_SUCCESS, to_id, -1, audit_msg);
+    
+    return 0;
+}
+
+int cap_region_grant(agent_id_t from_id, agent_id_t to_id, unsigned int region, unsigned int rights) {
+    // Check if initialized
+    if (!cap_initialized) {
+        return -1;
+    }
+    
+    // Validate arguments
+    if (from_id < -1 || from_id >= AGENT_MAX_COUNT || to_id < 0 || to_id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    if (region >= CAP_REGION_MAX || rights == 0 ||
+        (rights & ~(unsigned int)(CAP_REGION_READ | CAP_REGION_WRITE)) != 0) {
+        return -1;
+    }
+    
+    // Build message: "Granted region R rw to agent ID"
+    char audit_msg[128];
+    ksnprintf(audit_msg, 128, "Granted region %u %s to agent %d", region,
+              (rights & CAP_REGION_WRITE) ? "rw" : "r", to_id);
+    
+    // An agent can pass on only what it holds, and only to an agent that may hold regions
+    int allowed = cap_has(to_id, CAP_SHM);
+    if (from_id >= 0 && (cap_region_rights(from_id, region) & rights) != rights) {
+        allowed = 0;
+    }
+    if (!allowed) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_DENY, from_id, -1, audit_msg);
+        return -1;
+    }
+    
+    cap_region_table[to_id][region] |= (unsigned char)rights;
+    cap_dirty(cap_region_table[to_id][region]);
+    audit_emit(AUDIT_TYPE_USER_ACTION, AUDIT_RESULT_SUCCESS, to_id, -1, audit_msg);
+    
+    return 0;
+}
+
+unsigned int cap_region_rights(agent_id_t agent_id, unsigned int region) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT || region >= CAP_REGION_MAX) {
+        return 0;
+    }
+    
+    // Revoking CAP_SHM withdraws every region right with it
+    if (!cap_has(agent_id, CAP_SHM)) {
+        return 0;
+    }
+    return cap_region_table[agent_id][region];
+}
+
+unsigned int cap_revocation_epoch(void) {
+    return cap_epoch;
+}
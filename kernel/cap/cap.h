@@ -6,26 +6,90 @@
 
 #include "agent/agent.h"  // For AGENT_MAX_COUNT
 #include "audit/audit.h"  // For agent_id_t
+#include "quota/quota.h"  // For quota_t
 
 // Capability flags (bitmask)
 #define CAP_NONE           0x00000000
 #define CAP_CONSOLE_WRITE  0x00000001
+#define CAP_PROFILE        0x00000002  // Control the sampling profiler
+#define CAP_CONSOLE_CONTROL 0x00000004 // Switch console focus and scrollback
+#define CAP_AUDIT_READ     0x00000008  // Read-only audit view mapped into the agent
+#define CAP_CHANNEL        0x00000010  // Open agent-to-agent channels
+#define CAP_SHM            0x00000020  // Create, map and receive shared memory regions
+#define CAP_TIMER          0x00000040  // Arm a (periodic) alarm on the timing wheel
+#define CAP_CONSOLE_READ   0x00000080  // Read keyboard input
 // Future capabilities can be added as powers of 2:
-// #define CAP_SOME_OTHER    0x00000002
-// #define CAP_ANOTHER       0x00000004
+// #define CAP_SOME_OTHER    0x00000100
+
+// Number of capability bits tracked by the delegation trees
+#define CAP_BIT_COUNT 32
+
+// Maximum delegation depth (kernel grant = depth 0)
+// Bounds the lazy validity walk performed at check time
+#define CAP_DELEGATION_DEPTH_MAX 8
 
 // Capability bitmask type
 typedef unsigned int cap_mask_t;
 
+// Shared memory region rights (per agent, per region; see shm/shm.h)
+#define CAP_REGION_MAX   8
+#define CAP_REGION_READ  0x1
+#define CAP_REGION_WRITE 0x2
+
 // Initialize the capability system
 void cap_init(void);
 
-// Grant capabilities to an agent
+// Grant capabilities to an agent (kernel grant, root of a delegation tree)
 // Returns: 0 on success, -1 on failure (invalid agent_id)
 int cap_grant(agent_id_t agent_id, cap_mask_t mask);
 
+// Grant capabilities together with an intent rate quota
+// The quota is applied to every intent action whose required capability is
+// in mask (see intent_action_to_capability()). A null quota means unlimited.
+// Returns: 0 on success, -1 on failure (invalid agent_id)
+int cap_grant_quota(agent_id_t agent_id, cap_mask_t mask, const quota_t* quota);
+
+// Same grant without an audit record, for callers that audit a whole batch
+// themselves (agent_spawn_from_template() records one event per burst)
+// Returns: 0 on success, -1 on failure (invalid agent_id)
+int cap_grant_unaudited(agent_id_t agent_id, cap_mask_t mask, const quota_t* quota);
+
+// Revoke capabilities from an agent
+// O(1) per capability bit: the grant is invalidated and the global revocation
+// epoch is bumped. Grants delegated from it are detected as stale lazily, the
+// next time cap_has() runs for the holding agent.
+// Returns: 0 on success, -1 on failure (invalid agent_id)
+int cap_revoke(agent_id_t agent_id, cap_mask_t mask);
+
+// Drop everything an agent holds, without an audit record: its grants (and
+// with them anything it delegated), its region rights and its intent quotas,
+// so a freed agent slot starts clean for the next agent (agent_release())
+// Returns: 0 on success, -1 on failure (invalid agent_id)
+int cap_clear(agent_id_t agent_id);
+
+// Delegate capabilities from one agent to another
+// The delegating agent must hold all bits in mask. The new grants become
+// children of the delegator's grants, so revoking the delegator's grant also
+// revokes them. Bits the target already holds are left untouched.
+// Returns: 0 on success, -1 on failure (invalid IDs, capability not held, or depth exceeded)
+int cap_delegate(agent_id_t from_id, agent_id_t to_id, cap_mask_t mask);
+
 // Check if an agent has the specified capabilities (all bits must be set)
 // Returns: 1 if agent has all capabilities, 0 otherwise
 int cap_has(agent_id_t agent_id, cap_mask_t mask);
 
+// Grant rights on a shared memory region
+// from_id is the granting agent, or -1 for the kernel (a region's owner at
+// creation). An agent may only grant rights it holds, and both it and to_id
+// must hold CAP_SHM. Rights are only ever added; the grant is audited.
+// Returns: 0 on success, -1 on failure (invalid IDs/rights or not permitted)
+int cap_region_grant(agent_id_t from_id, agent_id_t to_id, unsigned int region, unsigned int rights);
+
+// Get an agent's effective rights on a region (none without CAP_SHM)
+// Returns: CAP_REGION_* mask, 0 if none or invalid arguments
+unsigned int cap_region_rights(agent_id_t agent_id, unsigned int region);
+
+// Get the current revocation epoch (incremented on every revoke)
+unsigned int cap_revocation_epoch(void);
+
 #endif // CAP_H
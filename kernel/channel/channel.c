@@ -0,0 +1,112 @@
+// AgentOS Channel Module Implementation
+// Week 3: Agent-to-agent single-producer/single-consumer message rings in shared pages
+
+#include "channel.h"
+#include "lib/string.h"
+
+// Ring storage, padded to whole pages so a mapping exposes only its own ring
+typedef union {
+    channel_ring_t ring;
+    unsigned char pages[CHANNEL_PAGES * PAGE_SIZE];
+} channel_store_t;
+
+static channel_store_t channel_store[CHANNEL_MAX] __attribute__((aligned(PAGE_SIZE)));
+
+// The ring must fit its pages, and every (direction, peer) slot the channel area
+typedef char channel_ring_fits[(sizeof(channel_ring_t) <= CHANNEL_PAGES * PAGE_SIZE &&
+                                CHANNEL_VIEW(CHANNEL_DIR_RECV, AGENT_MAX_COUNT) <=
+                                PAGING_CHANNEL_BASE + PAGING_CHANNEL_PAGES * PAGE_SIZE) ? 1 : -1];
+
+// Channel table entry
+typedef struct {
+    int in_use;
+    int producer;            // Agent ID of the sending end
+    int consumer;            // Agent ID of the receiving end
+    int open_mask;           // Ends mapped so far (1 << CHANNEL_DIR_*)
+} channel_t;
+
+static channel_t channel_table[CHANNEL_MAX];
+
+void channel_init(void) {
+    for (unsigned int i = 0; i < CHANNEL_MAX; i++) {
+        channel_table[i].in_use = 0;
+        channel_table[i].producer = -1;
+        channel_table[i].consumer = -1;
+        channel_table[i].open_mask = 0;
+    }
+}
+
+// Find the channel from producer to consumer, or -1
+static int channel_find(int producer, int consumer) {
+    for (int i = 0; i < CHANNEL_MAX; i++) {
+        if (channel_table[i].in_use && channel_table[i].producer == producer &&
+            channel_table[i].consumer == consumer) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+int channel_open(int agent_id, int peer_id, int dir) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT ||
+        peer_id < 0 || peer_id >= AGENT_MAX_COUNT || agent_id == peer_id) {
+        return -1;
+    }
+    if (dir != CHANNEL_DIR_SEND && dir != CHANNEL_DIR_RECV) {
+        return -1;
+    }
+    
+    int producer = dir == CHANNEL_DIR_SEND ? agent_id : peer_id;
+    int consumer = dir == CHANNEL_DIR_SEND ? peer_id : agent_id;
+    
+    int id = channel_find(producer, consumer);
+    if (id < 0) {
+        // First end: take a free slot and start with an empty ring
+        for (int i = 0; i < CHANNEL_MAX; i++) {
+            if (!channel_table[i].in_use) {
+                id = i;
+                break;
+            }
+        }
+        if (id < 0) {
+            return -1;
+        }
+        memset(&channel_store[id], 0, sizeof(channel_store[id]));
+        channel_table[id].in_use = 1;
+        channel_table[id].producer = producer;
+        channel_table[id].consumer = consumer;
+        channel_table[id].open_mask = 0;
+    } else if (channel_table[id].open_mask & (1 << dir)) {
+        return -1;
+    }
+    
+    // Both ends write the ring (head on one side, tail on the other)
+    if (paging_map_user(agent_id, CHANNEL_VIEW(dir, peer_id), &channel_store[id], CHANNEL_PAGES, 1) != 0) {
+        if (channel_table[id].open_mask == 0) {
+            channel_table[id].in_use = 0;
+        }
+        return -1;
+    }
+    channel_table[id].open_mask |= 1 << dir;
+    return 0;
+}
+
+void channel_release(int agent_id) {
+    for (unsigned int i = 0; i < CHANNEL_MAX; i++) {
+        channel_t* channel = &channel_table[i];
+        if (!channel->in_use || (channel->producer != agent_id && channel->consumer != agent_id)) {
+            continue;
+        }
+        
+        // The peer's end is mapped at the view named after agent_id
+        int peer_dir = channel->producer == agent_id ? CHANNEL_DIR_RECV : CHANNEL_DIR_SEND;
+        int peer_id = channel->producer == agent_id ? channel->consumer : channel->producer;
+        if (channel->open_mask & (1 << peer_dir)) {
+            paging_unmap_user(peer_id, CHANNEL_VIEW(peer_dir, agent_id), CHANNEL_PAGES);
+        }
+        channel->in_use = 0;
+        channel->producer = -1;
+        channel->consumer = -1;
+        channel->open_mask = 0;
+    }
+}
@@ -0,0 +1,79 @@
+// AgentOS Channel Module
+// Week 3: Agent-to-agent single-producer/single-consumer message rings in shared pages
+
+#ifndef CHANNEL_H
+#define CHANNEL_H
+
+#include "agent/agent.h"          // For AGENT_MAX_COUNT
+#include "arch/x86_64/paging.h"   // For PAGE_SIZE, PAGING_CHANNEL_BASE
+
+// Maximum number of open channels (each one producer -> one consumer)
+#define CHANNEL_MAX 8
+
+// Cache line size; producer- and consumer-owned fields never share a line
+#define CHANNEL_CACHE_LINE 64
+
+// Slots per ring (power of two); each slot is one cache line
+#define CHANNEL_SLOTS 64
+
+// Largest message carried by one slot
+#define CHANNEL_MSG_MAX (CHANNEL_CACHE_LINE - sizeof(unsigned int))
+
+// Pages per ring (header lines plus slots, rounded up)
+#define CHANNEL_PAGES 2
+
+// Ring directions, as seen by the agent opening it
+#define CHANNEL_DIR_SEND 0
+#define CHANNEL_DIR_RECV 1
+
+// Where a ring is mapped in an agent's space: one fixed slot per
+// (direction, peer), so agents find their rings without asking the kernel
+#define CHANNEL_VIEW(dir, peer) \
+    (PAGING_CHANNEL_BASE + ((unsigned long)(dir) * AGENT_MAX_COUNT + (unsigned long)(peer)) * CHANNEL_PAGES * PAGE_SIZE)
+#define CHANNEL_SEND_VIEW(peer) CHANNEL_VIEW(CHANNEL_DIR_SEND, peer)
+#define CHANNEL_RECV_VIEW(peer) CHANNEL_VIEW(CHANNEL_DIR_RECV, peer)
+
+// One message slot
+typedef struct {
+    unsigned int len;                          // Bytes used in data
+    unsigned char data[CHANNEL_MSG_MAX];
+} channel_msg_t;
+
+// Ring shared by both ends (mapped read/write into each)
+// head and tail are free-running counters: slot = counter % CHANNEL_SLOTS,
+// empty when head == tail, full when head - tail == CHANNEL_SLOTS.
+// Each side caches the other's counter in its own line and rereads the
+// shared one only when the cached value says full (producer) or empty
+// (consumer), so steady-state traffic touches only the slots.
+// Neither end trusts the other's counters or lengths beyond its own ring.
+typedef struct {
+    // Producer line
+    volatile unsigned int head;               // Next slot to fill (written by producer)
+    unsigned int tail_cache;                  // Producer's last view of tail
+    unsigned char producer_pad[CHANNEL_CACHE_LINE - 2 * sizeof(unsigned int)];
+    
+    // Consumer line
+    volatile unsigned int tail;               // Next slot to drain (written by consumer)
+    unsigned int head_cache;                  // Consumer's last view of head
+    unsigned char consumer_pad[CHANNEL_CACHE_LINE - 2 * sizeof(unsigned int)];
+    
+    channel_msg_t slots[CHANNEL_SLOTS];
+} channel_ring_t;
+
+// Initialize the channel table (no channels open)
+void channel_init(void);
+
+// Open one end of the channel between agent_id and peer_id
+// CHANNEL_DIR_SEND: agent_id produces for peer_id; CHANNEL_DIR_RECV: agent_id
+// consumes from peer_id. The first end opened allocates an empty ring; the
+// ring is mapped at CHANNEL_VIEW(dir, peer_id) in agent_id's space. Each end
+// must be opened by its own agent (both need CAP_CHANNEL).
+// Returns: 0 on success, -1 on failure (invalid IDs, end already open, or no free channel)
+int channel_open(int agent_id, int peer_id, int dir);
+
+// Close every channel agent_id is an end of, unmapping the ring from the
+// peer too, so a freed agent slot does not inherit them (agent_release();
+// the agent's own mappings go with its address space)
+void channel_release(int agent_id);
+
+#endif // CHANNEL_H
@@ -0,0 +1,116 @@
+// AgentOS Clock Module Implementation
+// Week 3: TSC-based cycle clock calibrated against the PIT
+
+#include "clock.h"
+#include "audit/audit.h"
+#include "lib/format.h"
+
+// PIT input frequency (Hz)
+#define PIT_FREQUENCY_HZ 1193182
+
+// PIT I/O ports
+#define PIT_CHANNEL2_PORT 0x42
+#define PIT_COMMAND_PORT  0x43
+#define PIT_GATE_PORT     0x61
+
+// Calibration window (milliseconds)
+#define CLOCK_CALIBRATION_MS 10
+
+// Fixed-point shift for cycles-to-nanoseconds conversion
+#define CLOCK_NS_SHIFT 22
+
+// TSC value at kernel entry (written by entry.S before kernel_main)
+extern unsigned long long boot_tsc;
+
+// Calibrated TSC rate
+static unsigned int clock_cycles_per_ms_value = CLOCK_FALLBACK_CYCLES_PER_MS;
+
+// Nanoseconds per cycle in CLOCK_NS_SHIFT fixed point: (10^6 << shift) / cycles_per_ms
+static unsigned int clock_ns_mult = (1000000ULL << CLOCK_NS_SHIFT) / CLOCK_FALLBACK_CYCLES_PER_MS;
+
+// Measure TSC cycles elapsed during one PIT channel 2 one-shot countdown
+static unsigned long long clock_measure_pit_window(void) {
+    unsigned int count = (PIT_FREQUENCY_HZ * CLOCK_CALIBRATION_MS) / 1000;
+    
+    // Enable channel 2 gate, keep the speaker disconnected
+    unsigned char gate = inb(PIT_GATE_PORT);
+    gate = (gate & ~0x02) | 0x01;
+    outb(PIT_GATE_PORT, gate);
+    
+    // Channel 2, lobyte/hibyte access, mode 0 (interrupt on terminal count)
+    outb(PIT_COMMAND_PORT, 0xB0);
+    outb(PIT_CHANNEL2_PORT, (unsigned char)(count & 0xFF));
+    outb(PIT_CHANNEL2_PORT, (unsigned char)((count >> 8) & 0xFF));
+    
+    // Restart the countdown by pulsing the gate low then high
+    outb(PIT_GATE_PORT, gate & ~0x01);
+    outb(PIT_GATE_PORT, gate | 0x01);
+    
+    unsigned long long start = rdtsc();
+    
+    // OUT2 (bit 5) goes high when the count reaches zero
+    while ((inb(PIT_GATE_PORT) & 0x20) == 0) {
+    }
+    
+    unsigned long long end = rdtsc();
+    
+    return end - start;
+}
+
+void clock_init(void) {
+    unsigned long long elapsed = clock_measure_pit_window();
+    unsigned int cycles_per_ms = (unsigned int)clock_div64(elapsed, CLOCK_CALIBRATION_MS);
+    
+    if (cycles_per_ms == 0) {
+        clock_cycles_per_ms_value = CLOCK_FALLBACK_CYCLES_PER_MS;
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "TSC calibration failed, assuming 1 GHz");
+        return;
+    }
+    
+    clock_cycles_per_ms_value = cycles_per_ms;
+    clock_ns_mult = (unsigned int)clock_div64(1000000ULL << CLOCK_NS_SHIFT, cycles_per_ms);
+    
+    // Build message: "Clock calibrated: N kHz TSC"
+    char audit_msg[64];
+    ksnprintf(audit_msg, 64, "Clock calibrated: %u kHz TSC", cycles_per_ms);
+    
+    audit_emit(AUDIT_TYPE_SYSTEM_INIT, AUDIT_RESULT_NONE, -1, -1, audit_msg);
+}
+
+unsigned int clock_cycles_per_ms(void) {
+    return clock_cycles_per_ms_value;
+}
+
+unsigned long long clock_boot_cycles(void) {
+    return boot_tsc;
+}
+
+unsigned long long clock_cycles_to_ns(unsigned long long cycles) {
+    // Split into 32-bit halves so neither partial product overflows 64 bits
+    unsigned long long hi = cycles >> 32;
+    unsigned long long lo = cycles & 0xFFFFFFFFULL;
+    return ((hi * clock_ns_mult) << (32 - CLOCK_NS_SHIFT)) + ((lo * clock_ns_mult) >> CLOCK_NS_SHIFT);
+}
+
+unsigned long long clock_now_ns(void) {
+    return clock_cycles_to_ns(clock_cycles() - boot_tsc);
+}
+
+unsigned long long clock_div64(unsigned long long dividend, unsigned int divisor) {
+    if (divisor == 0) {
+        return 0;
+    }
+    
+    // Binary long division (avoids __udivdi3 on i386)
+    unsigned long long quotient = 0;
+    unsigned long long remainder = 0;
+    for (int bit = 63; bit >= 0; bit--) {
+        remainder = (remainder << 1) | ((dividend >> bit) & 1);
+        if (remainder >= divisor) {
+            remainder -= divisor;
+            quotient |= 1ULL << bit;
+        }
+    }
+    
+    return quotient;
+}
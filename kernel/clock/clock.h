@@ -0,0 +1,38 @@
+// AgentOS Clock Module
+// Week 3: TSC-based cycle clock calibrated against the PIT
+
+#ifndef CLOCK_H
+#define CLOCK_H
+
+#include "arch/x86_64/io.h"  // For rdtsc()
+
+// Fallback TSC rate used if calibration fails (1 GHz)
+#define CLOCK_FALLBACK_CYCLES_PER_MS 1000000
+
+// Calibrate the TSC against PIT channel 2 (polled, no interrupts needed)
+// Must run before any module converts time units to cycles
+void clock_init(void);
+
+// Read the current cycle count (TSC); no port I/O
+static inline unsigned long long clock_cycles(void) {
+    return rdtsc();
+}
+
+// Get the calibrated TSC rate in cycles per millisecond
+unsigned int clock_cycles_per_ms(void);
+
+// Get the TSC value recorded by entry.S at GRUB handoff
+unsigned long long clock_boot_cycles(void);
+
+// Convert a cycle count (duration) to nanoseconds
+// Uses a precomputed multiply/shift, no division
+unsigned long long clock_cycles_to_ns(unsigned long long cycles);
+
+// Get monotonic nanoseconds since GRUB handoff
+unsigned long long clock_now_ns(void);
+
+// Divide a 64-bit value by a 32-bit divisor without libgcc helpers
+// Intended for configuration-time conversions, not hot paths
+unsigned long long clock_div64(unsigned long long dividend, unsigned int divisor);
+
+#endif // CLOCK_H
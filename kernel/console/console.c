@@ -0,0 +1,331 @@
+// AgentOS Virtual Console Module Implementation
+// Week 3: Per-agent off-screen consoles with scrollback and a lazy compositor
+
+#include "console.h"
+#include "vga.h"
+#include "lib/string.h"
+#include "timer/timer.h"
+#include "audit/audit.h"
+#include "arch/x86_64/idt.h"  // For interrupts_save/restore
+
+// One virtual console: a ring of fixed-width lines
+// Line n (0-based since the last clear) lives at lines[n & (CONSOLE_SCROLLBACK_LINES - 1)]
+typedef struct {
+    char lines[CONSOLE_SCROLLBACK_LINES][VGA_WIDTH];  // Space padded, not null-terminated
+    unsigned int line;     // Index of the line holding the cursor
+    unsigned int col;      // Cursor column within that line
+    unsigned int scroll;   // View offset from the newest line (0 = follow output)
+} console_t;
+
+// Pending output for one console: bytes accepted by console_enqueue() and
+// not yet appended; drained as a single write on the next timer tick
+typedef struct {
+    char data[CONSOLE_QUEUE_SIZE];
+    unsigned int len;
+} console_queue_t;
+
+// All consoles and their output queues (fixed-size, no heap)
+static console_t consoles[CONSOLE_COUNT];
+static console_queue_t console_queues[CONSOLE_COUNT];
+
+// Consoles with queued output (bit N = console N; CONSOLE_COUNT <= 32)
+static unsigned int console_queued_mask = 0;
+
+// Console shown on screen
+static int console_focus_id = CONSOLE_KERNEL;
+
+// One blank row, drawn below a console's newest line
+static char console_blank[VGA_WIDTH];
+
+// 1 when the focused console changed since the last composite
+static int console_dirty = 0;
+
+// Nesting depth of console_batch_begin()
+static unsigned int console_batch_depth = 0;
+
+// Initialization flag
+static int console_initialized = 0;
+
+// Console state is shared with the timer tick (queue drain), so every entry
+// point below runs with interrupts disabled via interrupts_save()/restore()
+
+// Line storage for a line index
+static char* console_line(console_t* con, unsigned int line) {
+    return con->lines[line & (CONSOLE_SCROLLBACK_LINES - 1)];
+}
+
+// Oldest line index still retained in the ring
+static unsigned int console_oldest(const console_t* con) {
+    return con->line >= CONSOLE_SCROLLBACK_LINES ? con->line - (CONSOLE_SCROLLBACK_LINES - 1) : 0;
+}
+
+// Largest valid view offset: the view's top row may not go past the oldest line
+static unsigned int console_max_scroll(const console_t* con) {
+    unsigned int retained = con->line - console_oldest(con) + 1;
+    return retained > VGA_HEIGHT ? retained - VGA_HEIGHT : 0;
+}
+
+// Start a new (blank) line
+static void console_newline(console_t* con) {
+    con->line++;
+    con->col = 0;
+    memset(console_line(con, con->line), ' ', VGA_WIDTH);
+}
+
+// Append len bytes to a console's lines and mark the screen dirty if it is focused
+static void console_append(int console_id, const char* s, unsigned int len) {
+    console_t* con = &consoles[console_id];
+    for (unsigned int i = 0; i < len; i++) {
+        if (s[i] == '\n') {
+            console_newline(con);
+            continue;
+        }
+        if (con->col >= VGA_WIDTH) {
+            console_newline(con);
+        }
+        console_line(con, con->line)[con->col++] = s[i];
+    }
+    
+    // Off-screen consoles never touch the device
+    if (console_id == console_focus_id) {
+        console_dirty = 1;
+    }
+}
+
+// Render the focused console's view into the VGA shadow and flush
+// Only rows whose text changed are marked dirty by vga_draw_row()
+static void console_composite(void) {
+    console_t* con = &consoles[console_focus_id];
+    
+    // Bottom of the view; short consoles are drawn from the top of the screen
+    unsigned int bottom = con->line - con->scroll;
+    unsigned int top = bottom >= VGA_HEIGHT - 1 ? bottom - (VGA_HEIGHT - 1) : 0;
+    
+    for (unsigned int row = 0; row < VGA_HEIGHT; row++) {
+        unsigned int line = top + row;
+        vga_draw_row(row, line <= bottom ? console_line(con, line) : console_blank);
+    }
+    
+    // Cursor follows the newest line while it is in view
+    if (con->scroll == 0) {
+        vga_set_cursor(con->line - top, con->col < VGA_WIDTH ? con->col : VGA_WIDTH - 1);
+    }
+    
+    vga_flush();
+    console_dirty = 0;
+}
+
+// Composite now unless a batch is open
+static void console_update(void) {
+    if (console_dirty && console_batch_depth == 0) {
+        console_composite();
+    }
+}
+
+// Move every queued byte into its console, one append per console, then
+// composite at most once (interrupts must be disabled)
+static void console_drain_locked(void) {
+    unsigned int pending = console_queued_mask;
+    console_queued_mask = 0;
+    
+    while (pending != 0) {
+        int console_id = __builtin_ctz(pending);
+        pending &= pending - 1;
+        console_append(console_id, console_queues[console_id].data, console_queues[console_id].len);
+        console_queues[console_id].len = 0;
+    }
+    console_update();
+}
+
+// Timer tick: drain output queued since the previous tick (runs with interrupts disabled)
+static void console_tick(interrupt_frame_t* frame) {
+    (void)frame;
+    if (console_queued_mask != 0) {
+        console_drain_locked();
+    }
+}
+
+void console_init(void) {
+    memset(console_blank, ' ', VGA_WIDTH);
+    for (unsigned int i = 0; i < CONSOLE_COUNT; i++) {
+        consoles[i].line = 0;
+        consoles[i].col = 0;
+        consoles[i].scroll = 0;
+        memset(console_line(&consoles[i], 0), ' ', VGA_WIDTH);
+        console_queues[i].len = 0;
+    }
+    
+    console_queued_mask = 0;
+    console_focus_id = CONSOLE_KERNEL;
+    console_batch_depth = 0;
+    console_initialized = 1;
+    console_dirty = 1;
+    console_update();
+}
+
+void console_queue_init(void) {
+    if (timer_register_tick(console_tick) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register console drain tick");
+    }
+}
+
+int console_write(int console_id, const char* s) {
+    // Check if initialized
+    if (!console_initialized) {
+        return -1;
+    }
+    
+    // Validate arguments
+    if (console_id < 0 || console_id >= CONSOLE_COUNT || s == 0) {
+        return -1;
+    }
+    
+    unsigned long flags = interrupts_save();
+    
+    // Keep ordering with anything still queued for this console
+    if (console_queued_mask & (1U << console_id)) {
+        console_drain_locked();
+    }
+    console_append(console_id, s, strlen(s));
+    console_update();
+    
+    interrupts_restore(flags);
+    return 0;
+}
+
+int console_enqueue(int console_id, const char* s) {
+    // Check if initialized
+    if (!console_initialized) {
+        return -1;
+    }
+    
+    // Validate arguments
+    if (console_id < 0 || console_id >= CONSOLE_COUNT || s == 0) {
+        return -1;
+    }
+    
+    unsigned int len = strlen(s);
+    unsigned long flags = interrupts_save();
+    console_queue_t* queue = &console_queues[console_id];
+    
+    // Backpressure: the write is refused whole rather than split
+    if (len > CONSOLE_QUEUE_SIZE - queue->len) {
+        interrupts_restore(flags);
+        return CONSOLE_ERR_FULL;
+    }
+    
+    memcpy(&queue->data[queue->len], s, len);
+    queue->len += len;
+    console_queued_mask |= 1U << console_id;
+    
+    interrupts_restore(flags);
+    return 0;
+}
+
+void console_drain(void) {
+    if (!console_initialized) {
+        return;
+    }
+    unsigned long flags = interrupts_save();
+    console_drain_locked();
+    interrupts_restore(flags);
+}
+
+int console_clear(int console_id) {
+    if (!console_initialized || console_id < 0 || console_id >= CONSOLE_COUNT) {
+        return -1;
+    }
+    
+    unsigned long flags = interrupts_save();
+    console_t* con = &consoles[console_id];
+    
+    // Output queued before the clear is discarded with the rest
+    console_queues[console_id].len = 0;
+    console_queued_mask &= ~(1U << console_id);
+    
+    con->line = 0;
+    con->col = 0;
+    con->scroll = 0;
+    memset(console_line(con, 0), ' ', VGA_WIDTH);
+    
+    if (console_id == console_focus_id) {
+        console_dirty = 1;
+        console_update();
+    }
+    interrupts_restore(flags);
+    return 0;
+}
+
+int console_focus(int console_id) {
+    if (!console_initialized || console_id < 0 || console_id >= CONSOLE_COUNT) {
+        return -1;
+    }
+    
+    unsigned long flags = interrupts_save();
+    if (console_id != console_focus_id) {
+        console_focus_id = console_id;
+        console_dirty = 1;
+        console_update();
+    }
+    interrupts_restore(flags);
+    return 0;
+}
+
+int console_focused(void) {
+    return console_focus_id;
+}
+
+void console_scroll(int lines) {
+    if (!console_initialized) {
+        return;
+    }
+    
+    unsigned long flags = interrupts_save();
+    console_t* con = &consoles[console_focus_id];
+    unsigned int max = console_max_scroll(con);
+    unsigned int scroll = con->scroll;
+    
+    if (lines > 0) {
+        scroll = (unsigned int)lines >= max - scroll ? max : scroll + (unsigned int)lines;
+    } else if (lines < 0) {
+        unsigned int back = (unsigned int)(-(lines + 1)) + 1;
+        scroll = back >= scroll ? 0 : scroll - back;
+    }
+    
+    if (scroll != con->scroll) {
+        con->scroll = scroll;
+        console_dirty = 1;
+        console_update();
+    }
+    interrupts_restore(flags);
+}
+
+void console_scroll_reset(void) {
+    if (!console_initialized) {
+        return;
+    }
+    
+    unsigned long flags = interrupts_save();
+    console_t* con = &consoles[console_focus_id];
+    if (con->scroll != 0) {
+        con->scroll = 0;
+        console_dirty = 1;
+        console_update();
+    }
+    interrupts_restore(flags);
+}
+
+void console_batch_begin(void) {
+    unsigned long flags = interrupts_save();
+    console_batch_depth++;
+    interrupts_restore(flags);
+}
+
+void console_batch_end(void) {
+    unsigned long flags = interrupts_save();
+    if (console_batch_depth > 0) {
+        console_batch_depth--;
+    }
+    console_update();
+    interrupts_restore(flags);
+}
@@ -0,0 +1,69 @@
+// AgentOS Virtual Console Module
+// Week 3: Per-agent off-screen consoles with scrollback and a lazy compositor
+
+#ifndef CONSOLE_H
+#define CONSOLE_H
+
+#include "agent/agent.h"  // For AGENT_MAX_COUNT
+
+// Console IDs: one per agent slot (console ID == agent ID) plus the kernel console
+#define CONSOLE_KERNEL AGENT_MAX_COUNT
+#define CONSOLE_COUNT (AGENT_MAX_COUNT + 1)
+
+// Scrollback kept per console, in lines (power of two)
+#define CONSOLE_SCROLLBACK_LINES 128
+
+// Bytes of not-yet-drained output each console accepts from console_enqueue()
+#define CONSOLE_QUEUE_SIZE 1024
+
+// Returned by console_enqueue() when the console's queue cannot take the write
+#define CONSOLE_ERR_FULL -2
+
+// Initialize all consoles (empty) and focus the kernel console
+// Requires vga_init()
+void console_init(void);
+
+// Register the timer tick that drains console_enqueue() output
+// Requires timer_init()
+void console_queue_init(void);
+
+// Append a null-terminated string to a console's buffer
+// Supports '\n'; long lines wrap at VGA_WIDTH. Only the focused console
+// reaches the screen (composited when the write or enclosing batch ends).
+// Returns: 0 on success, -1 on failure (not initialized, invalid console or string)
+int console_write(int console_id, const char* s);
+
+// Queue a null-terminated string for a console without touching its lines
+// Queued writes are appended on the next timer tick; all writes to a console
+// within one tick are merged into a single append and composite.
+// Returns: 0 on success, CONSOLE_ERR_FULL if the queue has no room for the
+//          whole string (nothing is queued), -1 on failure (invalid console or string)
+int console_enqueue(int console_id, const char* s);
+
+// Append all queued output now (e.g. before dumping or halting)
+void console_drain(void);
+
+// Discard a console's contents and scrollback
+// Returns: 0 on success, -1 on failure (invalid console)
+int console_clear(int console_id);
+
+// Show a console on screen
+// Returns: 0 on success, -1 on failure (invalid console)
+int console_focus(int console_id);
+
+// Currently focused console ID
+int console_focused(void);
+
+// Move the focused console's view through its scrollback
+// lines > 0 scrolls back (older output), lines < 0 scrolls forward;
+// the view is clamped to the retained history
+void console_scroll(int lines);
+
+// Return the focused console's view to the newest output
+void console_scroll_reset(void);
+
+// Group several console calls into one composite/flush (nestable)
+void console_batch_begin(void);
+void console_batch_end(void);
+
+#endif // CONSOLE_H
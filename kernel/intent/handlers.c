@@ -2,13 +2,94 @@
 // Week 2 Day 1: Concrete intent handlers
 
 #include "handlers.h"
-#include "vga.h"
+#include "console/console.h"
+#include "vga.h"  // For VGA_HEIGHT
+#include "prof/prof.h"
+#include "prof/bootprof.h"
+#include "channel/channel.h"
+#include "shm/shm.h"
+#include "timer/sleep.h"
+#include "keyboard.h"
+#include "lib/string.h"
+
+// Parse a decimal number below limit at *s, leaving *s after its last digit
+// Returns: the number, or -1 if there are no digits or it is out of range
+static int parse_number(const char** s, int limit) {
+    const char* p = *s;
+    int value = 0;
+    if (*p < '0' || *p > '9') {
+        return -1;
+    }
+    for (; *p >= '0' && *p <= '9'; p++) {
+        if (value >= limit) {
+            return -1;
+        }
+        value = value * 10 + (*p - '0');
+    }
+    *s = p;
+    return value < limit ? value : -1;
+}
+
+// Parse a decimal ID below limit that makes up the rest of the payload
+// Returns: the ID, or -1 if empty, not decimal, or out of range
+static int parse_id(const char* s, int limit) {
+    int id = parse_number(&s, limit);
+    return *s == '\0' ? id : -1;
+}
 
 // Handler for INTENT_CONSOLE_WRITE intent
-// Prints the intent payload to VGA console
-// Parameters: agent_id (unused but required by handler signature), intent (contains payload to print)
-// Returns: 0 on success, -1 on failure
+// Queues the intent payload for the submitting agent's virtual console
+// Parameters: agent_id (selects the console), intent (contains payload to print)
+// Returns: 0 on success, INTENT_ERR_BACKPRESSURE if the console queue is full, -1 on failure
 int handle_console_write(int agent_id, const intent_t* intent) {
+    // Validate intent pointer
+    if (intent == 0) {
+        return -1;
+    }
+    
+    // Queue for the next timer tick; bursts from this agent merge into one append
+    int result = console_enqueue(agent_id, intent->payload);
+    if (result == CONSOLE_ERR_FULL) {
+        return INTENT_ERR_BACKPRESSURE;
+    }
+    return result;
+}
+
+// Handler for INTENT_PROFILE_CONTROL intent
+// Starts, stops or dumps (over serial) the sampling profiler, or exports
+// the boot timeline
+// Parameters: agent_id (unused), intent (payload "start", "stop", "dump" or "boot")
+// Returns: 0 on success, -1 on failure (unknown command)
+int handle_profile_control(int agent_id, const intent_t* intent) {
+    // Mark unused parameter to suppress warning
+    (void)agent_id;
+    
+    // Validate intent pointer
+    if (intent == 0) {
+        return -1;
+    }
+    
+    if (strcmp(intent->payload, "start") == 0) {
+        prof_start();
+    } else if (strcmp(intent->payload, "stop") == 0) {
+        prof_stop();
+    } else if (strcmp(intent->payload, "dump") == 0) {
+        prof_dump_serial();
+    } else if (strcmp(intent->payload, "boot") == 0) {
+        bootprof_export_serial();
+    } else {
+        return -1;
+    }
+    
+    return 0;
+}
+
+// Handler for INTENT_CONSOLE_CONTROL intent
+// Switches which virtual console is on screen and moves through its scrollback
+// Parameters: agent_id (unused), intent (payload "focus <id>", "focus kernel",
+//             "scroll up", "scroll down" or "scroll end")
+// Returns: 0 on success, -1 on failure (unknown command or console)
+int handle_console_control(int agent_id, const intent_t* intent) {
     // Mark unused parameter to suppress warning
     (void)agent_id;
     
@@ -17,8 +98,196 @@ int handle_console_write(int agent_id, const intent_t* intent) {
         return -1;
     }
     
-    // Print payload to VGA console
-    vga_write(intent->payload);
+    const char* payload = intent->payload;
+    
+    if (strcmp(payload, "focus kernel") == 0) {
+        return console_focus(CONSOLE_KERNEL);
+    } else if (strcmp(payload, "scroll up") == 0) {
+        console_scroll(VGA_HEIGHT / 2);
+    } else if (strcmp(payload, "scroll down") == 0) {
+        console_scroll(-(VGA_HEIGHT / 2));
+    } else if (strcmp(payload, "scroll end") == 0) {
+        console_scroll_reset();
+    } else if (memcmp(payload, "focus ", 6) == 0) {
+        // "focus <id>": decimal console (agent) ID
+        int id = parse_id(payload + 6, CONSOLE_COUNT);
+        if (id < 0) {
+            return -1;
+        }
+        return console_focus(id);
+    } else {
+        return -1;
+    }
     
     return 0;
 }
+
+// Handler for INTENT_CHANNEL_OPEN intent
+// Opens the submitting agent's end of a channel and maps its ring
+// (at CHANNEL_SEND_VIEW(id) or CHANNEL_RECV_VIEW(id))
+// Parameters: agent_id (the opening end), intent (payload "send <id>" or "recv <id>")
+// Returns: 0 on success, -1 on failure (bad payload or channel_open() failure)
+int handle_channel_open(int agent_id, const intent_t* intent) {
+    // Validate intent pointer
+    if (intent == 0) {
+        return -1;
+    }
+    
+    const char* payload = intent->payload;
+    int dir;
+    if (memcmp(payload, "send ", 5) == 0) {
+        dir = CHANNEL_DIR_SEND;
+    } else if (memcmp(payload, "recv ", 5) == 0) {
+        dir = CHANNEL_DIR_RECV;
+    } else {
+        return -1;
+    }
+    
+    int peer = parse_id(payload + 5, AGENT_MAX_COUNT);
+    if (peer < 0) {
+        return -1;
+    }
+    return channel_open(agent_id, peer, dir);
+}
+
+// Handler for INTENT_SHM_CONTROL intent
+// Creates a shared memory region owned by the submitting agent (mapped at
+// SHM_VIEW(region)), or maps one it holds rights on into another agent
+// Parameters: agent_id (owner / granting agent), intent (payload
+//             "create <pages>", "create huge" or "map <region> <id> r|rw")
+// Returns: region ID for create, 0 for map, -1 on failure
+int handle_shm_control(int agent_id, const intent_t* intent) {
+    // Validate intent pointer
+    if (intent == 0) {
+        return -1;
+    }
+    
+    const char* payload = intent->payload;
+    
+    if (strcmp(payload, "create huge") == 0) {
+        return shm_create(agent_id, 0, 1);
+    } else if (memcmp(payload, "create ", 7) == 0) {
+        int pages = parse_id(payload + 7, SHM_REGION_MAX_PAGES + 1);
+        if (pages <= 0) {
+            return -1;
+        }
+        return shm_create(agent_id, (unsigned int)pages, 0);
+    } else if (memcmp(payload, "map ", 4) == 0) {
+        // "map <region> <id> r|rw"
+        const char* p = payload + 4;
+        int region = parse_number(&p, SHM_MAX);
+        if (region < 0 || *p++ != ' ') {
+            return -1;
+        }
+        int target = parse_number(&p, AGENT_MAX_COUNT);
+        if (target < 0 || *p++ != ' ') {
+            return -1;
+        }
+        unsigned int rights;
+        if (strcmp(p, "r") == 0) {
+            rights = CAP_REGION_READ;
+        } else if (strcmp(p, "rw") == 0) {
+            rights = CAP_REGION_READ | CAP_REGION_WRITE;
+        } else {
+            return -1;
+        }
+        return shm_map(agent_id, region, target, rights);
+    }
+    
+    return -1;
+}
+
+// Handler for INTENT_SLEEP intent
+// Halts the submitting agent for a number of milliseconds, or until its
+// alarm (INTENT_TIMER_ARM) fires; the CPU idles tickless meanwhile
+// Parameters: agent_id (the sleeping agent), intent (payload "<ms>" or "alarm")
+// Returns: 0 after a sleep, the alarm's expirations since the last wait for
+//          "alarm", INTENT_ERR_TIMEOUT if the intent deadline passed first,
+//          -1 on failure (bad payload or no alarm armed)
+int handle_sleep(int agent_id, const intent_t* intent) {
+    // Validate intent pointer
+    if (intent == 0) {
+        return -1;
+    }
+    
+    // Output queued before the sleep should not wait for it: the periodic
+    // tick that drains consoles is stopped while idle
+    console_drain();
+    
+    int result;
+    if (strcmp(intent->payload, "alarm") == 0) {
+        result = sleep_alarm_wait(agent_id);
+    } else {
+        int ms = parse_id(intent->payload, SLEEP_MS_MAX + 1);
+        if (ms < 0) {
+            return -1;
+        }
+        result = sleep_ms((unsigned int)ms);
+    }
+    return result == SLEEP_ERR_DEADLINE ? INTENT_ERR_TIMEOUT : result;
+}
+
+// Handler for INTENT_TIMER_ARM intent
+// Arms the submitting agent's alarm, once or periodically, or cancels it
+// Parameters: agent_id (alarm owner), intent (payload "<ms>", "<ms> every" or "cancel")
+// Returns: 0 on success, -1 on failure (bad payload or interval)
+int handle_timer_arm(int agent_id, const intent_t* intent) {
+    // Validate intent pointer
+    if (intent == 0) {
+        return -1;
+    }
+    
+    const char* payload = intent->payload;
+    
+    if (strcmp(payload, "cancel") == 0) {
+        return sleep_alarm_arm(agent_id, 0, 0);
+    }
+    
+    int ms = parse_number(&payload, SLEEP_MS_MAX + 1);
+    if (ms <= 0) {
+        return -1;
+    }
+    if (*payload == '\0') {
+        return sleep_alarm_arm(agent_id, (unsigned int)ms, 0);
+    } else if (strcmp(payload, " every") == 0) {
+        return sleep_alarm_arm(agent_id, (unsigned int)ms, 1);
+    }
+    
+    return -1;
+}
+
+// Handler for INTENT_CONSOLE_READ intent
+// Waits for the next typed byte; the agent halts until the keyboard IRQ
+// delivers input (no polling), or until the optional time limit
+// Parameters: agent_id (unused), intent (payload "" or "<ms>")
+// Returns: the byte (1-255), 0 if the time limit passed first,
+//          INTENT_ERR_TIMEOUT at the intent deadline, -1 on a bad payload
+int handle_console_read(int agent_id, const intent_t* intent) {
+    // Mark unused parameter to suppress warning
+    (void)agent_id;
+    
+    // Validate intent pointer
+    if (intent == 0) {
+        return -1;
+    }
+    
+    int ms = 0;
+    if (intent->payload[0] != '\0') {
+        ms = parse_id(intent->payload, SLEEP_MS_MAX + 1);
+        if (ms <= 0) {
+            return -1;
+        }
+    }
+    
+    // A prompt queued before the read must be on screen while waiting
+    console_drain();
+    
+    int result = sleep_until(keyboard_available, (unsigned int)ms);
+    if (result == SLEEP_ERR_DEADLINE) {
+        return INTENT_ERR_TIMEOUT;
+    }
+    if (result <= 0) {
+        return result;
+    }
+    return keyboard_read();
+}
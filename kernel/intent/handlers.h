@@ -7,9 +7,61 @@
 #include "intent.h"
 
 // Handler for INTENT_CONSOLE_WRITE intent
-// Prints the intent payload to VGA console
-// Parameters: agent_id (unused but required by handler signature), intent (contains payload to print)
-// Returns: 0 on success, -1 on failure
+// Queues the intent payload for the submitting agent's virtual console
+// Parameters: agent_id (selects the console), intent (contains payload to print)
+// Returns: 0 on success, INTENT_ERR_BACKPRESSURE if the console queue is full, -1 on failure
 int handle_console_write(int agent_id, const intent_t* intent);
 
+// Handler for INTENT_PROFILE_CONTROL intent
+// Starts, stops or dumps (over serial) the sampling profiler, or exports
+// the boot timeline ("boot")
+// Parameters: agent_id (unused), intent (payload "start", "stop", "dump" or "boot")
+// Returns: 0 on success, -1 on failure (unknown command)
+int handle_profile_control(int agent_id, const intent_t* intent);
+
+// Handler for INTENT_CONSOLE_CONTROL intent
+// Switches which virtual console is on screen and moves through its scrollback
+// Parameters: agent_id (unused), intent (payload "focus <id>", "focus kernel",
+//             "scroll up", "scroll down" or "scroll end")
+// Returns: 0 on success, -1 on failure (unknown command or console)
+int handle_console_control(int agent_id, const intent_t* intent);
+
+// Handler for INTENT_CHANNEL_OPEN intent
+// Opens the submitting agent's end of a channel and maps its ring
+// (at CHANNEL_SEND_VIEW(id) or CHANNEL_RECV_VIEW(id))
+// Parameters: agent_id (the opening end), intent (payload "send <id>" or "recv <id>")
+// Returns: 0 on success, -1 on failure (bad payload or channel_open() failure)
+int handle_channel_open(int agent_id, const intent_t* intent);
+
+// Handler for INTENT_SHM_CONTROL intent
+// Creates a shared memory region owned by the submitting agent (mapped at
+// SHM_VIEW(region)), or maps one it holds rights on into another agent
+// Parameters: agent_id (owner / granting agent), intent (payload
+//             "create <pages>", "create huge" or "map <region> <id> r|rw")
+// Returns: region ID for create, 0 for map, -1 on failure
+int handle_shm_control(int agent_id, const intent_t* intent);
+
+// Handler for INTENT_SLEEP intent
+// Halts the submitting agent for a number of milliseconds, or until its
+// alarm (INTENT_TIMER_ARM) fires; the CPU idles tickless meanwhile
+// Parameters: agent_id (the sleeping agent), intent (payload "<ms>" or "alarm")
+// Returns: 0 after a sleep, the alarm's expirations since the last wait for
+//          "alarm", INTENT_ERR_TIMEOUT if the intent deadline passed first,
+//          -1 on failure (bad payload or no alarm armed)
+int handle_sleep(int agent_id, const intent_t* intent);
+
+// Handler for INTENT_TIMER_ARM intent
+// Arms the submitting agent's alarm, once or periodically, or cancels it
+// Parameters: agent_id (alarm owner), intent (payload "<ms>", "<ms> every" or "cancel")
+// Returns: 0 on success, -1 on failure (bad payload or interval)
+int handle_timer_arm(int agent_id, const intent_t* intent);
+
+// Handler for INTENT_CONSOLE_READ intent
+// Waits for the next typed byte; the agent halts until the keyboard IRQ
+// delivers input (no polling), or until the optional time limit
+// Parameters: agent_id (unused), intent (payload "" or "<ms>")
+// Returns: the byte (1-255), 0 if the time limit passed first,
+//          INTENT_ERR_TIMEOUT at the intent deadline, -1 on a bad payload
+int handle_console_read(int agent_id, const intent_t* intent);
+
 #endif // INTENT_HANDLERS_H
@@ -12,12 +12,27 @@
 // Intent action types
 typedef enum {
     INTENT_CONSOLE_WRITE = 0,
+    INTENT_PROFILE_CONTROL,      // Payload: "start", "stop", "dump" or "boot"
+    INTENT_CONSOLE_CONTROL,      // Payload: "focus <id>", "focus kernel", "scroll up", "scroll down" or "scroll end"
+    INTENT_CHANNEL_OPEN,         // Payload: "send <id>" or "recv <id>"
+    INTENT_SHM_CONTROL,          // Payload: "create <pages>", "create huge" or "map <region> <id> r|rw"
+    INTENT_SLEEP,                // Payload: "<ms>" or "alarm"
+    INTENT_TIMER_ARM,            // Payload: "<ms>", "<ms> every" or "cancel"
+    INTENT_CONSOLE_READ,         // Payload: "" or "<ms>" (longest wait)
     // Future intent actions can be added here:
     // INTENT_FILE_READ,
     // INTENT_NETWORK_CONNECT,
     INTENT_MAX  // Sentinel value
 } intent_action_t;
 
+// Handler result: the handler's output sink is full and the intent was not
+// executed; reported to the agent as SYS_ERR_BACKPRESSURE (retry later)
+#define INTENT_ERR_BACKPRESSURE -2
+
+// Handler result: the handler was still waiting when the intent's deadline
+// passed; reported to the agent as SYS_ERR_TIMEOUT
+#define INTENT_ERR_TIMEOUT -3
+
 // Intent structure
 typedef struct {
     intent_action_t action;                  // Intent action type
@@ -30,9 +45,48 @@ static inline cap_mask_t intent_action_to_capability(intent_action_t action) {
     switch (action) {
         case INTENT_CONSOLE_WRITE:
             return CAP_CONSOLE_WRITE;
+        case INTENT_PROFILE_CONTROL:
+            return CAP_PROFILE;
+        case INTENT_CONSOLE_CONTROL:
+            return CAP_CONSOLE_CONTROL;
+        case INTENT_CHANNEL_OPEN:
+            return CAP_CHANNEL;
+        case INTENT_SHM_CONTROL:
+            return CAP_SHM;
+        case INTENT_SLEEP:
+            return CAP_NONE;     // Sleeping only gives up the agent's own time
+        case INTENT_TIMER_ARM:
+            return CAP_TIMER;
+        case INTENT_CONSOLE_READ:
+            return CAP_CONSOLE_READ;
         default:
             return CAP_NONE;
     }
 }
 
+// Map intent action to display name
+// Returns: action name, or "UNKNOWN" if out of range
+static inline const char* intent_action_to_string(intent_action_t action) {
+    switch (action) {
+        case INTENT_CONSOLE_WRITE:
+            return "CONSOLE_WRITE";
+        case INTENT_PROFILE_CONTROL:
+            return "PROFILE_CONTROL";
+        case INTENT_CONSOLE_CONTROL:
+            return "CONSOLE_CONTROL";
+        case INTENT_CHANNEL_OPEN:
+            return "CHANNEL_OPEN";
+        case INTENT_SHM_CONTROL:
+            return "SHM_CONTROL";
+        case INTENT_SLEEP:
+            return "SLEEP";
+        case INTENT_TIMER_ARM:
+            return "TIMER_ARM";
+        case INTENT_CONSOLE_READ:
+            return "CONSOLE_READ";
+        default:
+            return "UNKNOWN";
+    }
+}
+
 #endif // INTENT_H
@@ -2,6 +2,10 @@
 // Week 2 Day 1: Intent handler registry for dynamic intent dispatch
 
 #include "router.h"
+#include "clock/clock.h"
+#include "stats/stats.h"
+#include "trace/trace.h"
+#include "snapshot/snapshot.h"
 
 // Fixed-size handler registry table (one entry per intent action type)
 static intent_handler_t handler_table[INTENT_MAX];
@@ -10,12 +14,9 @@ static intent_handler_t handler_table[INTENT_MAX];
 static int router_initialized = 0;
 
 void intent_router_init(void) {
-    // Clear all handler entries (set to 0/NULL)
-    for (unsigned int i = 0; i < INTENT_MAX; i++) {
-        handler_table[i] = 0;
-    }
-    
+    // No handlers yet: the table starts zeroed in BSS
     router_initialized = 1;
+    snapshot_register(SNAPSHOT_SECTION_ROUTER, handler_table, sizeof(handler_table), 0);
 }
 
 int intent_register_handler(intent_action_t action, intent_handler_t handler) {
@@ -41,6 +42,7 @@ int intent_register_handler(intent_action_t action, intent_handler_t handler) {
     
     // Register handler
     handler_table[action] = handler;
+    snapshot_dirty(SNAPSHOT_SECTION_ROUTER, &handler_table[action], sizeof(handler_table[action]));
     
     return 0;
 }
@@ -59,3 +61,24 @@ intent_handler_t intent_get_handler(intent_action_t action) {
     // Return handler (may be 0/NULL if not registered)
     return handler_table[action];
 }
+
+int intent_dispatch(int agent_id, const intent_t* intent) {
+    // Validate intent pointer
+    if (intent == 0) {
+        return -1;
+    }
+    
+    intent_handler_t handler = intent_get_handler(intent->action);
+    if (handler == 0) {
+        return -1;
+    }
+    
+    // Time the handler alone (always on: two TSC reads and a histogram increment)
+    TRACE_BEGIN(TRACE_HANDLER, (int)intent->action);
+    unsigned long long start = clock_cycles();
+    int result = handler(agent_id, intent);
+    stats_record_handler((int)intent->action, clock_cycles() - start);
+    TRACE_END(TRACE_HANDLER, (int)intent->action);
+    
+    return result;
+}
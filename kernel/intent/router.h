@@ -8,7 +8,7 @@
 
 // Intent handler function type
 // Parameters: agent_id (the agent submitting the intent), intent (pointer to intent structure)
-// Returns: 0 on success, -1 on failure
+// Returns: 0 (or a non-negative action-specific result) on success, negative on failure
 typedef int (*intent_handler_t)(int agent_id, const intent_t* intent);
 
 // Initialize the intent router system
@@ -22,4 +22,9 @@ int intent_register_handler(intent_action_t action, intent_handler_t handler);
 // Returns: handler function pointer on success, 0 (NULL) if no handler registered or invalid action
 intent_handler_t intent_get_handler(intent_action_t action);
 
+// Invoke the registered handler for an intent
+// Times the call into the per-handler latency histogram (stats module)
+// Returns: handler result, or -1 if no handler is registered or invalid action
+int intent_dispatch(int agent_id, const intent_t* intent);
+
 #endif // INTENT_ROUTER_H
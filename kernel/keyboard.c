@@ -0,0 +1,170 @@
+// AgentOS Keyboard Driver Implementation
+// Week 3: Interrupt-driven PS/2 keyboard input with operator hotkeys
+
+#include "keyboard.h"
+#include "vga.h"  // For VGA_HEIGHT
+#include "console/console.h"
+#include "audit/audit.h"
+#include "arch/x86_64/io.h"
+#include "arch/x86_64/idt.h"
+#include "arch/x86_64/pic.h"
+
+// PS/2 controller ports
+#define KEYBOARD_DATA_PORT   0x60
+#define KEYBOARD_STATUS_PORT 0x64
+
+// Status: output buffer full
+#define KEYBOARD_STATUS_OUTPUT 0x01
+
+// Keyboard IRQ line
+#define KEYBOARD_IRQ 1
+
+// Scan code set 1 values the driver handles itself
+#define SC_EXTENDED    0xE0  // Prefix of the next code
+#define SC_RELEASE     0x80  // Set on key release
+#define SC_LEFT_SHIFT  0x2A
+#define SC_RIGHT_SHIFT 0x36
+#define SC_F1          0x3B
+#define SC_F10         0x44
+#define SC_F12         0x58
+#define SC_END         0x4F
+#define SC_PAGE_UP     0x49
+#define SC_PAGE_DOWN   0x51
+
+// Scan code set 1 to ASCII (US layout), unshifted and shifted; 0 = not a character
+static const char keyboard_map[2][0x3A] = {
+    {
+        0, 27, '1', '2', '3', '4', '5', '6', '7', '8', '9', '0', '-', '=', '\b',
+        '\t', 'q', 'w', 'e', 'r', 't', 'y', 'u', 'i', 'o', 'p', '[', ']', '\n',
+        0, 'a', 's', 'd', 'f', 'g', 'h', 'j', 'k', 'l', ';', '\'', '`',
+        0, '\\', 'z', 'x', 'c', 'v', 'b', 'n', 'm', ',', '.', '/', 0,
+        '*', 0, ' ',
+    },
+    {
+        0, 27, '!', '@', '#', '$', '%', '^', '&', '*', '(', ')', '_', '+', '\b',
+        '\t', 'Q', 'W', 'E', 'R', 'T', 'Y', 'U', 'I', 'O', 'P', '{', '}', '\n',
+        0, 'A', 'S', 'D', 'F', 'G', 'H', 'J', 'K', 'L', ':', '"', '~',
+        0, '|', 'Z', 'X', 'C', 'V', 'B', 'N', 'M', '<', '>', '?', 0,
+        '*', 0, ' ',
+    },
+};
+
+// Single-producer/single-consumer ring: the IRQ advances head, the reader
+// advances tail; free-running counters, slot = counter % KEYBOARD_BUFFER_SIZE
+static char keyboard_buffer[KEYBOARD_BUFFER_SIZE];
+static volatile unsigned int keyboard_head = 0;
+static volatile unsigned int keyboard_tail = 0;
+static volatile unsigned int keyboard_dropped_count = 0;
+
+// Decoder state (touched only by the IRQ)
+static int keyboard_shift = 0;
+static int keyboard_extended = 0;
+
+// Operator hotkeys: console focus and scrollback, applied at interrupt level
+// Returns: 1 if the code was a hotkey
+static int keyboard_hotkey(unsigned char code) {
+    if (code >= SC_F1 && code <= SC_F10) {
+        console_focus(code - SC_F1);
+    } else if (code == SC_F12) {
+        console_focus(CONSOLE_KERNEL);
+    } else if (code == SC_PAGE_UP) {
+        console_scroll(VGA_HEIGHT - 1);
+    } else if (code == SC_PAGE_DOWN) {
+        console_scroll(-(VGA_HEIGHT - 1));
+    } else if (code == SC_END) {
+        console_scroll_reset();
+    } else {
+        return 0;
+    }
+    return 1;
+}
+
+// IRQ1 handler
+static void keyboard_irq(interrupt_frame_t* frame) {
+    (void)frame;
+    unsigned char code = inb(KEYBOARD_DATA_PORT);
+    
+    if (code == SC_EXTENDED) {
+        keyboard_extended = 1;
+        return;
+    }
+    int extended = keyboard_extended;
+    keyboard_extended = 0;
+    
+    // Releases only matter for shift
+    if (code & SC_RELEASE) {
+        code &= (unsigned char)~SC_RELEASE;
+        if (code == SC_LEFT_SHIFT || code == SC_RIGHT_SHIFT) {
+            keyboard_shift = 0;
+        }
+        return;
+    }
+    if (code == SC_LEFT_SHIFT || code == SC_RIGHT_SHIFT) {
+        keyboard_shift = 1;
+        return;
+    }
+    
+    // Navigation keys arrive with or without the prefix (numpad)
+    if (keyboard_hotkey(code)) {
+        return;
+    }
+    if (extended || code >= sizeof(keyboard_map[0])) {
+        return;
+    }
+    
+    char c = keyboard_map[keyboard_shift][code];
+    if (c == 0) {
+        return;
+    }
+    
+    // Full: drop the newest byte (the reader owns the tail)
+    unsigned int head = keyboard_head;
+    if (head - keyboard_tail >= KEYBOARD_BUFFER_SIZE) {
+        keyboard_dropped_count++;
+        return;
+    }
+    keyboard_buffer[head % KEYBOARD_BUFFER_SIZE] = c;
+    
+    // Publish the byte before the new head
+    __asm__ volatile ("" : : : "memory");
+    keyboard_head = head + 1;
+}
+
+void keyboard_init(void) {
+    // Discard anything typed (or left by the firmware) before the handler exists
+    while (inb(KEYBOARD_STATUS_PORT) & KEYBOARD_STATUS_OUTPUT) {
+        (void)inb(KEYBOARD_DATA_PORT);
+    }
+    keyboard_head = 0;
+    keyboard_tail = 0;
+    keyboard_dropped_count = 0;
+    keyboard_shift = 0;
+    keyboard_extended = 0;
+    
+    if (interrupt_register(PIC_IRQ_BASE + KEYBOARD_IRQ, keyboard_irq) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register keyboard IRQ");
+        return;
+    }
+    pic_unmask(KEYBOARD_IRQ);
+}
+
+int keyboard_available(void) {
+    return keyboard_head != keyboard_tail;
+}
+
+int keyboard_read(void) {
+    unsigned int tail = keyboard_tail;
+    if (keyboard_head == tail) {
+        return 0;
+    }
+    
+    // Read the byte before handing its slot back to the IRQ
+    unsigned char c = (unsigned char)keyboard_buffer[tail % KEYBOARD_BUFFER_SIZE];
+    __asm__ volatile ("" : : : "memory");
+    keyboard_tail = tail + 1;
+    return c;
+}
+
+unsigned int keyboard_dropped(void) {
+    return keyboard_dropped_count;
+}
@@ -0,0 +1,29 @@
+// AgentOS Keyboard Driver
+// Week 3: Interrupt-driven PS/2 keyboard input with operator hotkeys
+
+#ifndef KEYBOARD_H
+#define KEYBOARD_H
+
+// Bytes of typed input buffered until an agent reads them (power of two)
+#define KEYBOARD_BUFFER_SIZE 256
+
+// Hook IRQ1 and unmask it; the controller's output buffer is flushed first
+// Operator hotkeys are handled in the IRQ itself and never buffered:
+//   F1-F10 focus agent console 0-9, F12 focuses the kernel console,
+//   Page Up / Page Down scroll the focused console, End returns to the newest output
+// Requires console_init() and idt_init()/pic_init()
+void keyboard_init(void);
+
+// Non-zero if typed input is waiting (lock-free: the IRQ only writes the
+// head, readers only write the tail)
+int keyboard_available(void);
+
+// Take the next typed byte (US layout, '\n' for Enter, '\b' for Backspace)
+// Must not be called concurrently by two readers
+// Returns: the byte (1-255), or 0 if none is waiting
+int keyboard_read(void);
+
+// Bytes dropped because the buffer was full
+unsigned int keyboard_dropped(void);
+
+#endif // KEYBOARD_H
@@ -0,0 +1,216 @@
+// AgentOS Kernel Formatter Implementation
+// Week 3: Bounded printf-style formatting for kernel messages
+
+#include "format.h"
+#include "string.h"
+
+// Longest digit string: 64-bit octal is not supported, so 20 decimal digits
+#define FORMAT_DIGITS_MAX 24
+
+// Output cursor bounded by the caller's buffer
+typedef struct {
+    char* buf;
+    unsigned int size;   // Capacity excluding terminator
+    unsigned int pos;
+} format_out_t;
+
+static void out_char(format_out_t* out, char c) {
+    if (out->pos < out->size) {
+        out->buf[out->pos++] = c;
+    }
+}
+
+static void out_repeat(format_out_t* out, char c, int count) {
+    while (count-- > 0) {
+        out_char(out, c);
+    }
+}
+
+// Divide a 64-bit value by a small divisor in place, returning the remainder.
+// Works on 16-bit limbs so every step is a 32-bit division (no libgcc helper).
+static unsigned int div_small(unsigned long long* value, unsigned int divisor) {
+    unsigned int hi = (unsigned int)(*value >> 32);
+    unsigned int lo = (unsigned int)*value;
+    unsigned int limbs[4] = { hi >> 16, hi & 0xFFFF, lo >> 16, lo & 0xFFFF };
+    unsigned int rem = 0;
+    
+    for (int i = 0; i < 4; i++) {
+        unsigned int cur = (rem << 16) | limbs[i];
+        limbs[i] = cur / divisor;
+        rem = cur % divisor;
+    }
+    
+    *value = ((unsigned long long)((limbs[0] << 16) | limbs[1]) << 32) |
+             ((limbs[2] << 16) | limbs[3]);
+    return rem;
+}
+
+// Render an unsigned value into digits (reverse order); returns digit count
+static int render_digits(char* digits, unsigned long long value, unsigned int base, int upper) {
+    const char* set = upper ? "0123456789ABCDEF" : "0123456789abcdef";
+    int count = 0;
+    
+    if (value == 0) {
+        digits[count++] = '0';
+        return count;
+    }
+    
+    while (value != 0 && count < FORMAT_DIGITS_MAX) {
+        if (base == 16) {
+            // Hex needs no division at all
+            digits[count++] = set[value & 0xF];
+            value >>= 4;
+        } else if ((value >> 32) == 0) {
+            // 32-bit fast path
+            unsigned int v = (unsigned int)value;
+            digits[count++] = set[v % base];
+            value = v / base;
+        } else {
+            digits[count++] = set[div_small(&value, base)];
+        }
+    }
+    return count;
+}
+
+// Emit a field (sign + digits or string) honoring width and justification
+static void out_field(format_out_t* out, const char* prefix, const char* body, int body_len,
+                      int reversed, int width, int left, int zero) {
+    int prefix_len = (int)strlen(prefix);
+    int pad = width - prefix_len - body_len;
+    
+    if (!left && !zero) {
+        out_repeat(out, ' ', pad);
+    }
+    for (int i = 0; i < prefix_len; i++) {
+        out_char(out, prefix[i]);
+    }
+    if (!left && zero) {
+        out_repeat(out, '0', pad);
+    }
+    for (int i = 0; i < body_len; i++) {
+        out_char(out, reversed ? body[body_len - 1 - i] : body[i]);
+    }
+    if (left) {
+        out_repeat(out, ' ', pad);
+    }
+}
+
+unsigned int kvsnprintf(char* buf, unsigned int size, const char* fmt, va_list args) {
+    if (buf == 0 || size == 0) {
+        return 0;
+    }
+    
+    format_out_t out = { buf, size - 1, 0 };
+    
+    for (const char* p = fmt; *p != '\0'; p++) {
+        if (*p != '%') {
+            out_char(&out, *p);
+            continue;
+        }
+        p++;
+        
+        // Flags
+        int left = 0;
+        int zero = 0;
+        for (;; p++) {
+            if (*p == '-') {
+                left = 1;
+            } else if (*p == '0') {
+                zero = 1;
+            } else {
+                break;
+            }
+        }
+        
+        // Width
+        int width = 0;
+        while (*p >= '0' && *p <= '9') {
+            width = width * 10 + (*p - '0');
+            p++;
+        }
+        
+        // Length modifier
+        int longs = 0;
+        while (*p == 'l') {
+            longs++;
+            p++;
+        }
+        
+        char digits[FORMAT_DIGITS_MAX];
+        unsigned long long value;
+        
+        switch (*p) {
+            case 'd':
+            case 'i': {
+                long long sv;
+                if (longs >= 2) {
+                    sv = va_arg(args, long long);
+                } else if (longs == 1) {
+                    sv = va_arg(args, long);
+                } else {
+                    sv = va_arg(args, int);
+                }
+                value = sv < 0 ? (unsigned long long)(-(sv + 1)) + 1 : (unsigned long long)sv;
+                int n = render_digits(digits, value, 10, 0);
+                out_field(&out, sv < 0 ? "-" : "", digits, n, 1, width, left, zero);
+                break;
+            }
+            case 'u':
+            case 'x':
+            case 'X': {
+                if (longs >= 2) {
+                    value = va_arg(args, unsigned long long);
+                } else if (longs == 1) {
+                    value = va_arg(args, unsigned long);
+                } else {
+                    value = va_arg(args, unsigned int);
+                }
+                int n = render_digits(digits, value, *p == 'u' ? 10 : 16, *p == 'X');
+                out_field(&out, "", digits, n, 1, width, left, zero);
+                break;
+            }
+            case 'p': {
+                value = (unsigned long)va_arg(args, void*);
+                int n = render_digits(digits, value, 16, 0);
+                out_field(&out, "0x", digits, n, 1, width, left, zero);
+                break;
+            }
+            case 'c': {
+                char c = (char)va_arg(args, int);
+                out_field(&out, "", &c, 1, 0, width, left, 0);
+                break;
+            }
+            case 's': {
+                const char* s = va_arg(args, const char*);
+                if (s == 0) {
+                    s = "(null)";
+                }
+                out_field(&out, "", s, (int)strlen(s), 0, width, left, 0);
+                break;
+            }
+            case '%':
+                out_char(&out, '%');
+                break;
+            case '\0':
+                // Trailing lone '%': stop at the terminator
+                p--;
+                break;
+            default:
+                // Unknown conversion: emit it verbatim
+                out_char(&out, '%');
+                out_char(&out, *p);
+                break;
+        }
+    }
+    
+    buf[out.pos] = '\0';
+    return out.pos;
+}
+
+unsigned int ksnprintf(char* buf, unsigned int size, const char* fmt, ...) {
+    va_list args;
+    va_start(args, fmt);
+    unsigned int n = kvsnprintf(buf, size, fmt, args);
+    va_end(args);
+    return n;
+}
@@ -0,0 +1,24 @@
+// AgentOS Kernel Formatter
+// Week 3: Bounded printf-style formatting for kernel messages
+
+#ifndef LIB_FORMAT_H
+#define LIB_FORMAT_H
+
+#include <stdarg.h>
+
+// Format into buf (size bytes including terminator); output is always
+// null-terminated when size > 0 and silently truncated when it does not fit.
+//
+// Supported conversions: %d %i %u %x %X %c %s %p %%
+// Flags: '-' (left justify), '0' (zero pad); decimal field width
+// Length modifiers: l, ll (64-bit with ll)
+//
+// Returns: number of characters written (excluding the terminator), so
+//          callers can append with buf + n / size - n without overrunning
+unsigned int ksnprintf(char* buf, unsigned int size, const char* fmt, ...)
+    __attribute__((format(printf, 3, 4)));
+
+// va_list variant of ksnprintf
+unsigned int kvsnprintf(char* buf, unsigned int size, const char* fmt, va_list args);
+
+#endif // LIB_FORMAT_H
@@ -0,0 +1,162 @@
+// AgentOS Kernel String and Memory Primitives Implementation
+// Week 3: Shared freestanding replacements for libc string functions
+
+#include "string.h"
+
+// Native word used for word-at-a-time scans (may alias any object)
+typedef unsigned long __attribute__((may_alias)) kword_t;
+
+// Word with 0x01 in every byte and word with 0x80 in every byte
+#define WORD_ONES  ((kword_t)-1 / 0xFF)
+#define WORD_HIGHS (WORD_ONES * 0x80)
+
+// Nonzero if any byte of w is zero
+#define WORD_HAS_ZERO(w) (((w) - WORD_ONES) & ~(w) & WORD_HIGHS)
+
+#if defined(__x86_64__)
+#define REP_MOVS_WORD "rep movsq"
+#define REP_STOS_WORD "rep stosq"
+#else
+#define REP_MOVS_WORD "rep movsl"
+#define REP_STOS_WORD "rep stosl"
+#endif
+
+void* memcpy(void* dest, const void* src, ksize_t n) {
+    void* d = dest;
+    ksize_t words = n / sizeof(kword_t);
+    ksize_t tail = n % sizeof(kword_t);
+    
+    __asm__ volatile (
+        REP_MOVS_WORD "\n\t"
+        "mov %3, %%ecx\n\t"
+        "rep movsb"
+        : "+D"(d), "+S"(src), "+c"(words)
+        : "r"((unsigned int)tail)
+        : "memory"
+    );
+    
+    return dest;
+}
+
+void* memmove(void* dest, const void* src, ksize_t n) {
+    unsigned char* d = (unsigned char*)dest;
+    const unsigned char* s = (const unsigned char*)src;
+    
+    if (d == s || n == 0) {
+        return dest;
+    }
+    
+    // Forward copy is safe unless dest starts inside src
+    if (d < s || d >= s + n) {
+        return memcpy(dest, src, n);
+    }
+    
+    // Overlapping with dest after src: copy backwards with the direction flag set
+    d += n - 1;
+    s += n - 1;
+    __asm__ volatile (
+        "std\n\t"
+        "rep movsb\n\t"
+        "cld"
+        : "+D"(d), "+S"(s), "+c"(n)
+        :
+        : "memory"
+    );
+    
+    return dest;
+}
+
+void* memset(void* dest, int value, ksize_t n) {
+    void* d = dest;
+    kword_t pattern = WORD_ONES * (unsigned char)value;
+    ksize_t words = n / sizeof(kword_t);
+    ksize_t tail = n % sizeof(kword_t);
+    
+    __asm__ volatile (
+        REP_STOS_WORD "\n\t"
+        "mov %3, %%ecx\n\t"
+        "rep stosb"
+        : "+D"(d), "+c"(words)
+        : "a"(pattern), "r"((unsigned int)tail)
+        : "memory"
+    );
+    
+    return dest;
+}
+
+int memcmp(const void* a, const void* b, ksize_t n) {
+    const unsigned char* pa = (const unsigned char*)a;
+    const unsigned char* pb = (const unsigned char*)b;
+    for (ksize_t i = 0; i < n; i++) {
+        if (pa[i] != pb[i]) {
+            return (int)pa[i] - (int)pb[i];
+        }
+    }
+    return 0;
+}
+
+ksize_t strlen(const char* s) {
+    const char* p = s;
+    
+    // Byte steps until word aligned
+    while (((unsigned long)p & (sizeof(kword_t) - 1)) != 0) {
+        if (*p == '\0') {
+            return (ksize_t)(p - s);
+        }
+        p++;
+    }
+    
+    // Aligned word reads never cross a page boundary, so reading past the
+    // terminator within the final word is safe
+    const kword_t* w = (const kword_t*)p;
+    while (!WORD_HAS_ZERO(*w)) {
+        w++;
+    }
+    
+    p = (const char*)w;
+    while (*p != '\0') {
+        p++;
+    }
+    return (ksize_t)(p - s);
+}
+
+ksize_t strnlen(const char* s, ksize_t max_len) {
+    ksize_t len = 0;
+    
+    // Byte steps until word aligned
+    while (len < max_len && ((unsigned long)(s + len) & (sizeof(kword_t) - 1)) != 0) {
+        if (s[len] == '\0') {
+            return len;
+        }
+        len++;
+    }
+    
+    // Whole words that fit inside the limit
+    while (len + sizeof(kword_t) <= max_len && !WORD_HAS_ZERO(*(const kword_t*)(s + len))) {
+        len += sizeof(kword_t);
+    }
+    
+    while (len < max_len && s[len] != '\0') {
+        len++;
+    }
+    return len;
+}
+
+int strcmp(const char* a, const char* b) {
+    ksize_t i = 0;
+    while (a[i] != '\0' && a[i] == b[i]) {
+        i++;
+    }
+    return (int)(unsigned char)a[i] - (int)(unsigned char)b[i];
+}
+
+ksize_t strlcpy(char* dest, const char* src, ksize_t size) {
+    if (size == 0) {
+        return 0;
+    }
+    
+    ksize_t len = strnlen(src, size - 1);
+    memcpy(dest, src, len);
+    dest[len] = '\0';
+    return len;
+}
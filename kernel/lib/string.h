@@ -0,0 +1,39 @@
+// AgentOS Kernel String and Memory Primitives
+// Week 3: Shared freestanding replacements for libc string functions
+
+#ifndef LIB_STRING_H
+#define LIB_STRING_H
+
+// Size type for memory and string primitives (matches the native word)
+typedef unsigned long ksize_t;
+
+// Copy n bytes (regions must not overlap)
+// Uses `rep movs` on native words, then a byte tail
+void* memcpy(void* dest, const void* src, ksize_t n);
+
+// Copy n bytes; regions may overlap
+void* memmove(void* dest, const void* src, ksize_t n);
+
+// Fill n bytes with value
+// Uses `rep stos` on native words, then a byte tail
+void* memset(void* dest, int value, ksize_t n);
+
+// Compare n bytes
+// Returns: <0, 0 or >0 like libc memcmp
+int memcmp(const void* a, const void* b, ksize_t n);
+
+// Length of a null-terminated string (word-at-a-time scan)
+ksize_t strlen(const char* s);
+
+// Length of a string, reading at most max_len bytes
+ksize_t strnlen(const char* s, ksize_t max_len);
+
+// Compare two null-terminated strings
+// Returns: <0, 0 or >0 like libc strcmp
+int strcmp(const char* a, const char* b);
+
+// Copy a string into a buffer of size bytes, always null-terminating (if size > 0)
+// Returns: number of characters copied (excluding the terminator)
+ksize_t strlcpy(char* dest, const char* src, ksize_t size);
+
+#endif // LIB_STRING_H
@@ -2,74 +2,368 @@
 // Week 2 Day 1: Agent and audit system integration with capability enforcement
 
 #include "agent/agent.h"
+#include "agent/template.h"
 #include "audit/audit.h"
 #include "cap/cap.h"
 #include "syscall/syscall.h"
 #include "intent/intent.h"
 #include "intent/router.h"
 #include "intent/handlers.h"
+#include "clock/clock.h"
+#include "quota/quota.h"
+#include "stats/stats.h"
+#include "trace/trace.h"
+#include "serial.h"
+#include "vga.h"
+#include "keyboard.h"
+#include "multiboot.h"
+#include "tunable/tunable.h"
+#include "console/console.h"
+#include "channel/channel.h"
+#include "shm/shm.h"
+#include "timer/timer.h"
+#include "timer/wheel.h"
+#include "timer/sleep.h"
+#include "prof/prof.h"
+#include "prof/bootprof.h"
+#include "module/module.h"
+#include "snapshot/snapshot.h"
+#include "user/user.h"
+#include "lib/string.h"
+#include "arch/x86_64/gdt.h"
+#include "arch/x86_64/idt.h"
+#include "arch/x86_64/pic.h"
+#include "arch/x86_64/paging.h"
+#include "arch/x86_64/usermode.h"
+#include "arch/x86_64/io.h"
 
-// Helper function to copy string to intent payload (no libc)
-static void copy_to_payload(intent_t* intent, const char* msg) {
-    unsigned int i = 0;
-    while (msg[i] != '\0' && i < INTENT_PAYLOAD_MAX - 1) {
-        intent->payload[i] = msg[i];
-        i++;
+// Agent payloads live in the .user image so ring-3 code can pass them
+static const char init_agent_msg[] USER_RODATA = "init agent: Hello from init!\n";
+static const char demo_agent_msg[] USER_RODATA = "demo agent: Hello from demo!\n";
+static const char monitor_agent_msg[] USER_RODATA = "monitor agent: saw a denied intent\n";
+static const char producer_agent_msgs[][24] USER_RODATA = {
+    "consumer agent: ping 1\n",
+    "consumer agent: ping 2\n",
+};
+static const char producer_agent_bulk[] USER_RODATA = "consumer agent: bulk data read in place from a shared region\n";
+static const char ticker_agent_arm[] USER_RODATA = "10 every";
+static const char ticker_agent_wait[] USER_RODATA = "alarm";
+static const char ticker_agent_sleep[] USER_RODATA = "5";
+static const char ticker_agent_msg[] USER_RODATA = "ticker agent: tick\n";
+static const char worker_agent_greeting[] = "worker agent: hello from a cloned image\n";
+static const char operator_agent_prompt[] USER_RODATA = "operator agent: 0-9 or k focuses a console\n";
+
+// Simple entry function for "init" agent (runs in ring 3)
+USER_TEXT static void init_agent_entry(void* context) {
+    // The kernel knows which agent is calling; the context is unused
+    (void)context;
+    
+    // Submit a console write intent through the fast syscall path
+    // (should succeed if capability granted)
+    user_intent_submit(INTENT_CONSOLE_WRITE, init_agent_msg);
+}
+
+// Simple entry function for "demo" agent (runs in ring 3)
+USER_TEXT static void demo_agent_entry(void* context) {
+    (void)context;
+    
+    // Submit a console write intent (should fail if capability not granted)
+    user_intent_submit(INTENT_CONSOLE_WRITE, demo_agent_msg);
+}
+
+// Entry function for "monitor" agent (runs in ring 3)
+// Tails the audit log through its read-only view (CAP_AUDIT_READ), no syscalls
+USER_TEXT static void monitor_agent_entry(void* context) {
+    (void)context;
+    
+    // Each record is copied to the stack only once its snapshot is consistent
+    audit_event_t event;
+    unsigned int next_seq = 0;
+    int denied = 0;
+    while (user_audit_next(&next_seq, &event)) {
+        if (event.result == AUDIT_RESULT_DENY && event.intent_action >= 0) {
+            denied = 1;
+        }
+    }
+    
+    if (denied) {
+        user_intent_submit(INTENT_CONSOLE_WRITE, monitor_agent_msg);
+    }
+}
+
+// Entry function for "producer" agent (runs in ring 3)
+// Context: consumer agent ID. Pushes messages into the shared ring with
+// plain stores after one CHANNEL_OPEN intent, then hands over a bulk buffer
+// by mapping a shared region into the consumer and sending only its ID
+USER_TEXT static void producer_agent_entry(void* context) {
+    int consumer = (int)(unsigned long)context;
+    if (user_channel_open(CHANNEL_DIR_SEND, consumer) != 0) {
+        return;
+    }
+    for (unsigned int i = 0; i < sizeof(producer_agent_msgs) / sizeof(producer_agent_msgs[0]); i++) {
+        user_channel_send(consumer, producer_agent_msgs[i], sizeof(producer_agent_msgs[i]));
+    }
+    
+    long region = user_shm_create(1, 0);
+    if (region < 0) {
+        return;
+    }
+    char* buffer = (char*)SHM_VIEW(region);
+    for (unsigned int i = 0; i < sizeof(producer_agent_bulk); i++) {
+        buffer[i] = producer_agent_bulk[i];
+    }
+    if (user_shm_map((int)region, consumer, 0) == 0) {
+        unsigned char id = (unsigned char)region;
+        user_channel_send(consumer, &id, 1);
+    }
+}
+
+// Entry function for "consumer" agent (runs in ring 3)
+// Context: producer agent ID. Drains the ring and prints each message; a
+// one-byte message is a shared region ID, whose text is printed in place
+USER_TEXT static void consumer_agent_entry(void* context) {
+    int producer = (int)(unsigned long)context;
+    if (user_channel_open(CHANNEL_DIR_RECV, producer) != 0) {
+        return;
+    }
+    
+    // Received text is on the stack, which is valid payload memory
+    char msg[CHANNEL_MSG_MAX + 1];
+    int len;
+    while ((len = user_channel_recv(producer, msg, CHANNEL_MSG_MAX)) >= 0) {
+        if (len == 1) {
+            user_intent_submit(INTENT_CONSOLE_WRITE, (const char*)SHM_VIEW((unsigned char)msg[0]));
+            continue;
+        }
+        msg[len] = '\0';
+        user_intent_submit(INTENT_CONSOLE_WRITE, msg);
+    }
+}
+
+// Entry function for "ticker" agent (runs in ring 3)
+// Arms a periodic 10 ms alarm and prints a line each time it fires; the CPU
+// idles tickless between expirations
+USER_TEXT static void ticker_agent_entry(void* context) {
+    (void)context;
+    
+    if (user_intent_submit(INTENT_TIMER_ARM, ticker_agent_arm) != 0) {
+        return;
+    }
+    for (int i = 0; i < 3; i++) {
+        if (user_intent_submit(INTENT_SLEEP, ticker_agent_wait) < 0) {
+            return;
+        }
+        user_intent_submit(INTENT_CONSOLE_WRITE, ticker_agent_msg);
     }
-    intent->payload[i] = '\0';
+    
+    // A plain sleep needs no capability
+    user_intent_submit(INTENT_SLEEP, ticker_agent_sleep);
 }
 
-// Simple entry function for "init" agent
-static void init_agent_entry(void* context) {
-    // Context is the agent ID
-    int agent_id = (int)(long)context;
+// Entry function for "operator" agent (runs in ring 3)
+// Turns keystrokes into console control intents and echoes everything else;
+// each read halts until the keyboard IRQ delivers a key. Ends after
+// OPERATOR_IDLE_MS without input, so an unattended boot is not held up
+#define OPERATOR_IDLE_MS 1000
+USER_TEXT static void operator_agent_entry(void* context) {
+    (void)context;
     
-    // Create intent for console write
-    intent_t intent;
-    intent.action = INTENT_CONSOLE_WRITE;
-    copy_to_payload(&intent, "init agent: Hello from init!\n");
+    user_intent_submit(INTENT_CONSOLE_WRITE, operator_agent_prompt);
     
-    // Submit intent (should succeed if capability granted)
-    sys_intent_submit(agent_id, &intent);
+    long key;
+    while ((key = user_console_read(OPERATOR_IDLE_MS)) > 0) {
+        if (key >= '0' && key <= '9') {
+            user_console_focus((int)(key - '0'));
+        } else if (key == 'k') {
+            user_console_focus(CONSOLE_KERNEL);
+        } else {
+            char echo[2];
+            echo[0] = (char)key;
+            echo[1] = '\0';
+            user_intent_submit(INTENT_CONSOLE_WRITE, echo);
+        }
+    }
 }
 
-// Simple entry function for "demo" agent
-static void demo_agent_entry(void* context) {
-    // Context is the agent ID
-    int agent_id = (int)(long)context;
+// Entry function for "spinner" agent (runs in ring 3)
+// Never returns: stopped by the timer tick once its CPU budget is used up
+USER_TEXT static void spinner_agent_entry(void* context) {
+    (void)context;
     
-    // Create intent for console write
-    intent_t intent;
-    intent.action = INTENT_CONSOLE_WRITE;
-    copy_to_payload(&intent, "demo agent: Hello from demo!\n");
+    for (;;) {
+    }
+}
+
+// Agents spawned from the worker template
+#define WORKER_COUNT 4
+
+// Entry function for "worker" agents (run in ring 3), spawned from a template
+// Prints the greeting the kernel pre-built in the template's window image;
+// the first store copies that page into the worker's own frame
+USER_TEXT static void worker_agent_entry(void* context) {
+    (void)context;
     
-    // Submit intent (should fail if capability not granted)
-    sys_intent_submit(agent_id, &intent);
+    char* greeting = (char*)PAGING_AGENT_WINDOW;
+    greeting[0] = 'W';
+    user_intent_submit(INTENT_CONSOLE_WRITE, greeting);
 }
 
-void kernel_main(void) {
+// Register the kernel's intent handlers (restored instead on a warm boot)
+static void register_intent_handlers(void) {
+    if (intent_register_handler(INTENT_CONSOLE_WRITE, handle_console_write) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register console write handler");
+    }
+    if (intent_register_handler(INTENT_PROFILE_CONTROL, handle_profile_control) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register profile control handler");
+    }
+    if (intent_register_handler(INTENT_CONSOLE_CONTROL, handle_console_control) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register console control handler");
+    }
+    if (intent_register_handler(INTENT_CHANNEL_OPEN, handle_channel_open) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register channel open handler");
+    }
+    if (intent_register_handler(INTENT_SHM_CONTROL, handle_shm_control) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register shared memory handler");
+    }
+    if (intent_register_handler(INTENT_SLEEP, handle_sleep) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register sleep handler");
+    }
+    if (intent_register_handler(INTENT_TIMER_ARM, handle_timer_arm) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register timer arm handler");
+    }
+    if (intent_register_handler(INTENT_CONSOLE_READ, handle_console_read) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register console read handler");
+    }
+}
+
+// Create a boot agent, or on a warm boot find the one the snapshot restored
+static int boot_agent(int warm, const char* name, agent_entry_t entry, void* context) {
+    return warm ? agent_find(name) : agent_create(name, entry, context);
+}
+
+// QEMU isa-debug-exit port (iobase of the device make bench adds)
+#define BENCH_EXIT_PORT 0xf4
+
+void kernel_main(unsigned long multiboot_magic, unsigned long multiboot_info) {
+    // Record GRUB's boot modules and command line (read in place, before
+    // anything could overwrite the boot information)
+    int multiboot_ok = multiboot_init(multiboot_magic, multiboot_info) == 0;
+    
+    // Per-boot tunables from the kernel command line ("name=value" words on
+    // the multiboot2 line in grub.cfg), before any module reads them
+    tunable_init(multiboot_cmdline());
+    
+    // Bring up COM1 first so machine-readable exports are available to every phase
+    serial_init();
+    
+    // Console shadow buffer (cleared screen, hardware cursor at top-left),
+    // then the per-agent virtual consoles with the kernel console in focus
+    vga_init();
+    console_init();
+    bootprof_mark("early_console");
+    
+    // Take over CPU tables from GRUB: own GDT, exception/IRQ vectors, remapped PIC
+    // (interrupts stay disabled until the timer is programmed)
+    gdt_init();
+    idt_init();
+    pic_init();
+    bootprof_mark("cpu_tables");
+    
     // Initialize audit system first (it emits its own init event)
     audit_init();
     
     // Emit boot event with structured record
     audit_emit(AUDIT_TYPE_SYSTEM_INIT, AUDIT_RESULT_NONE, -1, -1, "BOOT: Kernel starting");
+    if (!multiboot_ok) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "No Multiboot2 boot information (no modules)");
+    }
+    tunable_audit();
+    bootprof_mark("audit");
+    
+    // Calibrate the TSC (needed by quotas before any grant with a rate limit)
+    clock_init();
+    bootprof_mark("clock");
+    
+    // Global large-page kernel map plus one address space per agent slot
+    // (PCID-tagged on x86_64 when available)
+    paging_init();
+    bootprof_mark("paging");
+    
+    // Ring-3 agents: sysenter/syscall fast path and the int 0x80 gate
+    usermode_init();
+    syscall_init();
+    bootprof_mark("usermode");
+    
+    // Initialize intent quota system (all agents unlimited until granted a quota)
+    quota_init();
+    
+    // Start the periodic timer tick and hook the sampling profiler and the
+    // console output drain into it
+    timer_init(tunable_get(TUNABLE_TIMER_HZ));
+    prof_init();
+    console_queue_init();
+    
+    // Timing wheel on the same tick (sleeps, alarms, intent deadlines)
+    wheel_init();
+    sleep_init();
+    
+    // Keyboard input (IRQ1) and the operator's console hotkeys
+    keyboard_init();
+    interrupts_enable();
+    bootprof_mark("timers_input");
+    
+#ifdef CONFIG_PROFILE_BOOT
+    // Profile the whole boot path (make PROFILE=1); dumped over serial at the end
+    prof_start();
+#endif
+    
+    // Initialize intent statistics (always-on counters and histograms)
+    stats_init();
+    bootprof_mark("stats");
     
     // Initialize capability system
     cap_init();
+    bootprof_mark("cap");
     
     // Initialize intent router system
     intent_router_init();
+    bootprof_mark("router");
     
-    // Register intent handlers
-    if (intent_register_handler(INTENT_CONSOLE_WRITE, handle_console_write) != 0) {
-        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register console write handler");
-    }
+    // No agent-to-agent channels or shared regions yet
+    channel_init();
+    shm_init();
+    bootprof_mark("ipc");
     
-    // Initialize agent system
+    // Initialize agent system (before a snapshot is restored into it)
     agent_init();
+    agent_template_init();
+    bootprof_mark("agent_init");
+    
+#ifdef CONFIG_BENCH
+    // Burst-spawn cost while the agent table is still empty (the clones are
+    // released before any boot agent is created); not boot work either
+    unsigned long long spawn_bench_start = clock_cycles();
+    agent_template_bench();
+    bootprof_exclude(clock_cycles() - spawn_bench_start);
+    bootprof_mark("spawn_bench");
+#endif
+    
+    // Warm boot: bring the boot agents, their capabilities, the audit ring
+    // and the handler registrations back from the snapshot disk instead of
+    // replaying the setup below (cold boot if there is no usable snapshot,
+    // or with snapshot=0 on the command line)
+    int snapshot_ok = tunable_get(TUNABLE_SNAPSHOT) && snapshot_init() == 0;
+    int warm = snapshot_ok && snapshot_restore() == 0;
+    bootprof_mark("snapshot");
+    
+    // Register intent handlers
+    if (!warm) {
+        register_intent_handlers();
+    }
+    bootprof_mark("handlers");
     
     // Create "init" agent (will be agent 0, assuming sequential creation)
-    int init_id = agent_create("init", init_agent_entry, (void*)(long)0);
+    int init_id = boot_agent(warm, "init", init_agent_entry, 0);
     if (init_id < 0) {
         audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to create init agent");
         audit_dump_to_console();
@@ -78,10 +372,10 @@ void kernel_main(void) {
         }
     }
     // Note: Since agent_create returns the first available slot index,
-    // init_id should be 0 (first agent created). Context was set to 0 above.
+    // init_id should be 0 (first agent created).
     
     // Create "demo" agent (will be agent 1, assuming sequential creation)
-    int demo_id = agent_create("demo", demo_agent_entry, (void*)(long)1);
+    int demo_id = boot_agent(warm, "demo", demo_agent_entry, 0);
     if (demo_id < 0) {
         audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to create demo agent");
         audit_dump_to_console();
@@ -89,30 +383,205 @@ void kernel_main(void) {
             __asm__ volatile ("hlt");
         }
     }
-    // Note: demo_id should be 1 (second agent created). Context was set to 1 above.
+    // Note: demo_id should be 1 (second agent created).
+    
+    // Create "monitor" agent (agent 2): watches the audit log without syscalls
+    int monitor_id = boot_agent(warm, "monitor", monitor_agent_entry, 0);
+    if (monitor_id < 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to create monitor agent");
+    }
+    
+    // Create a "producer" -> "consumer" pipeline (agents 3 and 4); each one
+    // gets the other's ID as its context (slots are handed out in order, so
+    // the consumer takes the slot after the producer's)
+    int producer_id = boot_agent(warm, "producer", producer_agent_entry, (void*)(unsigned long)(agent_count() + 1));
+    int consumer_id = boot_agent(warm, "consumer", consumer_agent_entry, (void*)(unsigned long)producer_id);
+    if (producer_id < 0 || consumer_id != producer_id + 1) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to create pipeline agents");
+    }
+    
+    // Create "ticker" agent (agent 5): periodic work on the timing wheel
+    int ticker_id = boot_agent(warm, "ticker", ticker_agent_entry, 0);
+    if (ticker_id < 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to create ticker agent");
+    }
+    
+    // Create "spinner" agent (agent 6): a runaway loop on a small CPU budget
+    int spinner_id = boot_agent(warm, "spinner", spinner_agent_entry, 0);
+    if (spinner_id < 0 || (!warm && agent_set_budget(spinner_id, 20) != 0)) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to create spinner agent");
+    }
+    
+    // Create "operator" agent (agent 7): interactive console control
+    int operator_id = boot_agent(warm, "operator", operator_agent_entry, 0);
+    if (operator_id < 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to create operator agent");
+    }
+    
+    // Grant the boot agents their capabilities (a warm boot restored them)
+    if (!warm) {
+        // Grant CAP_CONSOLE_WRITE to init agent only (demo gets nothing)
+        if (cap_grant(init_id, CAP_CONSOLE_WRITE) != 0) {
+            audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to grant capability to init agent");
+        }
+        if (monitor_id >= 0 && cap_grant(monitor_id, CAP_AUDIT_READ | CAP_CONSOLE_WRITE) != 0) {
+            audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to grant capability to monitor agent");
+        }
+        if (producer_id >= 0 && consumer_id == producer_id + 1) {
+            cap_grant(producer_id, CAP_CHANNEL | CAP_SHM);
+            cap_grant(consumer_id, CAP_CHANNEL | CAP_SHM | CAP_CONSOLE_WRITE);
+        }
+        if (ticker_id >= 0) {
+            cap_grant(ticker_id, CAP_TIMER | CAP_CONSOLE_WRITE);
+        }
+        if (operator_id >= 0) {
+            cap_grant(operator_id, CAP_CONSOLE_READ | CAP_CONSOLE_CONTROL | CAP_CONSOLE_WRITE);
+        }
+    }
     
-    // Grant CAP_CONSOLE_WRITE to init agent only
-    if (cap_grant(init_id, CAP_CONSOLE_WRITE) != 0) {
-        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to grant capability to init agent");
+    // Cold boot: checkpoint the finished setup so the next boot restores it
+    if (snapshot_ok && !warm && snapshot_checkpoint() < 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to write boot snapshot");
     }
+    bootprof_mark("agent_setup");
+    
+#ifdef CONFIG_BENCH
+    // Checkpoint cost while the tables still hold the setup state (the
+    // snapshot on disk stays restorable, which it would not after the agents
+    // below ran). Its disk writes are not boot work, so they are left out of
+    // the time to the first agent
+    unsigned long long snapshot_bench_start = clock_cycles();
+    snapshot_bench();
+    bootprof_exclude(clock_cycles() - snapshot_bench_start);
+    bootprof_mark("snapshot_bench");
+#endif
     
-    // Run init agent (has capability, sys_intent_submit should succeed)
-    // init_agent_entry will be called with context=0, which is init_id
+    // Run init agent in ring 3 (has capability, its intent should succeed)
     if (agent_run(init_id) != 0) {
         audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, init_id, -1, "init agent failed to run");
     }
+    bootprof_mark("run_init");
     
-    // Run demo agent (no capability, sys_intent_submit should fail)
-    // demo_agent_entry will be called with context=1, which is demo_id
+    // Run demo agent in ring 3 (no capability, its intent should be denied)
     if (agent_run(demo_id) != 0) {
         audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, demo_id, -1, "demo agent failed to run");
     }
+    bootprof_mark("run_demo");
+    
+    // Run monitor agent with the audit view mapped; it reports the denial above
+    if (monitor_id >= 0) {
+        if (agent_run(monitor_id) != 0) {
+            audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, monitor_id, -1, "monitor agent failed to run");
+        }
+    }
+    bootprof_mark("run_monitor");
+    
+    // Run the pipeline: the producer fills the ring and a shared region,
+    // then the consumer drains the ring and reads the region
+    if (producer_id >= 0 && consumer_id == producer_id + 1) {
+        if (agent_run(producer_id) != 0) {
+            audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, producer_id, -1, "producer agent failed to run");
+        }
+        if (agent_run(consumer_id) != 0) {
+            audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, consumer_id, -1, "consumer agent failed to run");
+        }
+    }
+    bootprof_mark("run_pipeline");
+    
+    // Run the ticker: its alarm is cancelled when the run ends
+    if (ticker_id >= 0) {
+        if (agent_run(ticker_id) != 0) {
+            audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, ticker_id, -1, "ticker agent failed to run");
+        }
+    }
+    bootprof_mark("run_ticker");
     
-    // Dump audit log to VGA console (all events in chronological order)
+    // Burst-spawn workers from a template: one audit record, no per-agent
+    // grants, and windows shared copy-on-write with the pre-built image
+    int worker_template = agent_template_create("worker", worker_agent_entry, CAP_CONSOLE_WRITE, 0, 100);
+    char* worker_image = (char*)agent_template_image(worker_template);
+    int worker_ids[WORKER_COUNT];
+    if (worker_image == 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to create worker template");
+    } else {
+        strlcpy(worker_image, worker_agent_greeting, PAGING_AGENT_WINDOW_SIZE);
+        if (agent_spawn_from_template(worker_template, WORKER_COUNT, 0, worker_ids) == 0) {
+            for (int i = 0; i < WORKER_COUNT; i++) {
+                if (agent_run(worker_ids[i]) != 0) {
+                    audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, worker_ids[i], -1, "worker agent failed to run");
+                }
+            }
+        }
+    }
+    bootprof_mark("run_workers");
+    
+    // Register the agent modules GRUB loaded (module2 lines in grub.cfg) and
+    // run them; each is relocated in place just before its first run
+    module_load_all();
+    for (unsigned int i = 0; i < module_count(); i++) {
+        int module_id = module_agent(i);
+        if (agent_run(module_id) != 0) {
+            audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, module_id, -1, "module agent failed to run");
+        }
+    }
+    bootprof_mark("run_modules");
+    
+    // Run the spinner: it never returns, so the tick stops it at 20 ms CPU
+    if (spinner_id >= 0) {
+        if (agent_run(spinner_id) != 0) {
+            audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, spinner_id, -1, "spinner agent failed to run");
+        }
+    }
+    bootprof_mark("run_spinner");
+    
+    // Run the operator: reads keys until the keyboard goes quiet
+    if (operator_id >= 0) {
+        if (agent_run(operator_id) != 0) {
+            audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, operator_id, -1, "operator agent failed to run");
+        }
+    }
+    bootprof_mark("run_operator");
+    
+#ifdef CONFIG_BENCH
+    // Microbenchmarks (make BENCH=1); results go to serial, preceded by
+    // the tunables they ran with
+    tunable_export_serial();
+    paging_bench();
+    syscall_bench();
+    audit_bench();
+    bootprof_bench();
+    serial_write("BENCH-END\n");
+#endif
+    
+    // Flush agent console output still queued for the next tick
+    console_drain();
+    
+    // Dump audit log to the kernel console (all events in chronological order)
     audit_dump_to_console();
     
-    // Halt the CPU in infinite loop
+    // Show per-agent intent counters and latency histograms below the audit log
+    stats_dump_to_console();
+    
+    // Boot timeline: time per phase and from GRUB handoff to the first agent
+    bootprof_dump_to_console();
+    
+    // Export trace rings over serial (no-op unless built with TRACE=1)
+    trace_export_serial();
+    
+#ifdef CONFIG_PROFILE_BOOT
+    prof_stop();
+    prof_dump_serial();
+    bootprof_export_serial();
+#endif
+    
+#ifdef CONFIG_BENCH
+    // Headless runs (make bench) end here: QEMU's isa-debug-exit device
+    // quits on any write to its port (elsewhere the write is ignored)
+    outb(BENCH_EXIT_PORT, 0);
+#endif
+    
+    // Idle forever; with no timer armed the tick is stopped entirely
     while (1) {
-        __asm__ volatile ("hlt");
+        wheel_idle();
     }
 }
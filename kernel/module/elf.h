@@ -0,0 +1,124 @@
+// AgentOS ELF Definitions
+// Week 3: Native-class ELF relocatable object layout (ELF32 on i386, ELF64 on x86_64)
+
+#ifndef ELF_H
+#define ELF_H
+
+// Identification
+#define ELF_MAGIC0 0x7F
+#define ELF_MAGIC1 'E'
+#define ELF_MAGIC2 'L'
+#define ELF_MAGIC3 'F'
+#define ELF_IDENT_CLASS 4
+#define ELF_IDENT_DATA 5
+#define ELF_DATA_LSB 1
+#define ELF_TYPE_REL 1
+
+#if defined(__x86_64__)
+#define ELF_CLASS_NATIVE 2
+#define ELF_MACHINE_NATIVE 62    // EM_X86_64
+#else
+#define ELF_CLASS_NATIVE 1
+#define ELF_MACHINE_NATIVE 3     // EM_386
+#endif
+
+// Section types and flags
+#define ELF_SHT_SYMTAB 2
+#define ELF_SHT_RELA 4
+#define ELF_SHT_NOBITS 8
+#define ELF_SHT_REL 9
+#define ELF_SHF_WRITE 0x1
+#define ELF_SHF_ALLOC 0x2
+
+// Special section indices
+#define ELF_SHN_UNDEF 0
+#define ELF_SHN_ABS 0xFFF1
+
+// Symbol binding (upper nibble of st_info)
+#define ELF_SYM_BIND(info) ((info) >> 4)
+#define ELF_STB_GLOBAL 1
+
+// Relocation types: S = symbol, A = addend, P = place
+#if defined(__x86_64__)
+#define ELF_R_64    1            // S + A, 64-bit
+#define ELF_R_PC32  2            // S + A - P, 32-bit
+#define ELF_R_PLT32 4            // Same as PC32 (no PLT in a static load)
+#define ELF_R_32    10           // S + A, zero-extended 32-bit
+#define ELF_R_32S   11           // S + A, sign-extended 32-bit
+#define ELF_R_SYM(info) ((unsigned long)(info) >> 32)
+#define ELF_R_TYPE(info) ((unsigned long)(info) & 0xFFFFFFFFUL)
+#else
+#define ELF_R_32    1            // S + A
+#define ELF_R_PC32  2            // S + A - P
+#define ELF_R_PLT32 4            // Same as PC32 (no PLT in a static load)
+#define ELF_R_SYM(info) ((unsigned long)(info) >> 8)
+#define ELF_R_TYPE(info) ((unsigned long)(info) & 0xFFUL)
+#endif
+
+// File header (addresses and offsets are native words in both classes)
+typedef struct {
+    unsigned char e_ident[16];
+    unsigned short e_type;
+    unsigned short e_machine;
+    unsigned int e_version;
+    unsigned long e_entry;
+    unsigned long e_phoff;
+    unsigned long e_shoff;
+    unsigned int e_flags;
+    unsigned short e_ehsize;
+    unsigned short e_phentsize;
+    unsigned short e_phnum;
+    unsigned short e_shentsize;
+    unsigned short e_shnum;
+    unsigned short e_shstrndx;
+} elf_ehdr_t;
+
+// Section header
+typedef struct {
+    unsigned int sh_name;
+    unsigned int sh_type;
+    unsigned long sh_flags;
+    unsigned long sh_addr;
+    unsigned long sh_offset;
+    unsigned long sh_size;
+    unsigned int sh_link;
+    unsigned int sh_info;
+    unsigned long sh_addralign;
+    unsigned long sh_entsize;
+} elf_shdr_t;
+
+// Symbol (field order differs between the classes)
+#if defined(__x86_64__)
+typedef struct {
+    unsigned int st_name;
+    unsigned char st_info;
+    unsigned char st_other;
+    unsigned short st_shndx;
+    unsigned long st_value;
+    unsigned long st_size;
+} elf_sym_t;
+#else
+typedef struct {
+    unsigned int st_name;
+    unsigned long st_value;
+    unsigned long st_size;
+    unsigned char st_info;
+    unsigned char st_other;
+    unsigned short st_shndx;
+} elf_sym_t;
+#endif
+
+// Relocation without addend (i386 .rel sections: the addend is in place)
+typedef struct {
+    unsigned long r_offset;
+    unsigned long r_info;
+} elf_rel_t;
+
+// Relocation with addend (x86_64 .rela sections)
+typedef struct {
+    unsigned long r_offset;
+    unsigned long r_info;
+    long r_addend;
+} elf_rela_t;
+
+#endif // ELF_H
@@ -0,0 +1,456 @@
+// AgentOS Agent Module Loader Implementation
+// Week 3: GRUB-loaded ELF boot modules registered as agents, relocated lazily
+
+#include "module.h"
+#include "elf.h"
+#include "agent/agent.h"
+#include "audit/audit.h"
+#include "cap/cap.h"
+#include "user/user.h"
+#include "arch/x86_64/paging.h"
+#include "lib/string.h"
+#include "lib/format.h"
+
+// Ring-3 library functions a module may call (resolved by name)
+typedef struct {
+    const char* name;
+    unsigned long addr;
+} module_export_t;
+
+static const module_export_t module_exports[] = {
+    { "user_syscall", (unsigned long)user_syscall },
+    { "user_intent_submit", (unsigned long)user_intent_submit },
+    { "user_audit_next", (unsigned long)user_audit_next },
+    { "user_channel_open", (unsigned long)user_channel_open },
+    { "user_channel_send", (unsigned long)user_channel_send },
+    { "user_channel_recv", (unsigned long)user_channel_recv },
+    { "user_shm_create", (unsigned long)user_shm_create },
+    { "user_shm_map", (unsigned long)user_shm_map },
+    { "user_console_read", (unsigned long)user_console_read },
+    { "user_console_focus", (unsigned long)user_console_focus },
+};
+
+#define MODULE_EXPORT_COUNT (sizeof(module_exports) / sizeof(module_exports[0]))
+
+// Module table entry
+typedef struct {
+    unsigned char* base;         // Module bytes (kernel address), patched in place
+    unsigned long size;
+    const elf_shdr_t* sections;
+    unsigned int section_count;
+    unsigned int symtab;         // Section index of the symbol table
+    int agent_id;
+    int relocated;
+} module_t;
+
+static module_t module_table[MODULE_MAX];
+static unsigned int module_total = 0;
+
+// Address a module section has in its agent's space (the file is mapped as is)
+static inline unsigned long module_section_addr(const module_t* m, unsigned int index) {
+    return PAGING_MODULE_VIEW + m->sections[index].sh_offset;
+}
+
+// Check the ELF header and every section against the module bounds
+// Returns: 0 if usable, -1 with *reason set otherwise
+static int module_check(module_t* m, const char** reason) {
+    const elf_ehdr_t* ehdr = (const elf_ehdr_t*)m->base;
+    if (m->size < sizeof(elf_ehdr_t) ||
+        ehdr->e_ident[0] != ELF_MAGIC0 || ehdr->e_ident[1] != ELF_MAGIC1 ||
+        ehdr->e_ident[2] != ELF_MAGIC2 || ehdr->e_ident[3] != ELF_MAGIC3) {
+        *reason = "not an ELF file";
+        return -1;
+    }
+    if (ehdr->e_ident[ELF_IDENT_CLASS] != ELF_CLASS_NATIVE || ehdr->e_ident[ELF_IDENT_DATA] != ELF_DATA_LSB ||
+        ehdr->e_machine != ELF_MACHINE_NATIVE || ehdr->e_type != ELF_TYPE_REL) {
+        *reason = "not a relocatable object for this architecture";
+        return -1;
+    }
+    if (ehdr->e_shentsize != sizeof(elf_shdr_t) || (ehdr->e_shoff & (sizeof(unsigned long) - 1)) != 0 ||
+        ehdr->e_shoff > m->size || ehdr->e_shnum > (m->size - ehdr->e_shoff) / sizeof(elf_shdr_t)) {
+        *reason = "bad section table";
+        return -1;
+    }
+    
+    m->sections = (const elf_shdr_t*)(m->base + ehdr->e_shoff);
+    m->section_count = ehdr->e_shnum;
+    m->symtab = 0;
+    for (unsigned int i = 1; i < m->section_count; i++) {
+        const elf_shdr_t* sh = &m->sections[i];
+        if (sh->sh_type != ELF_SHT_NOBITS && (sh->sh_offset > m->size || sh->sh_size > m->size - sh->sh_offset)) {
+            *reason = "section outside the module";
+            return -1;
+        }
+        if ((sh->sh_flags & ELF_SHF_ALLOC) && sh->sh_size != 0) {
+            // Mapped read-only as loaded: no data, no BSS
+            if (sh->sh_type == ELF_SHT_NOBITS || (sh->sh_flags & ELF_SHF_WRITE)) {
+                *reason = "writable section";
+                return -1;
+            }
+            if (sh->sh_addralign > 1 && (sh->sh_offset & (sh->sh_addralign - 1)) != 0) {
+                *reason = "misaligned section";
+                return -1;
+            }
+        }
+        if (sh->sh_type == ELF_SHT_SYMTAB) {
+            if (m->symtab != 0 || sh->sh_entsize != sizeof(elf_sym_t) || sh->sh_link == 0 ||
+                sh->sh_link >= m->section_count || (sh->sh_offset & (sizeof(unsigned long) - 1)) != 0) {
+                *reason = "bad symbol table";
+                return -1;
+            }
+            m->symtab = i;
+        }
+    }
+    if (m->symtab == 0) {
+        *reason = "no symbol table";
+        return -1;
+    }
+    return 0;
+}
+
+// Name of a symbol, or 0 if it does not lie in the string table
+static const char* module_symbol_name(const module_t* m, const elf_sym_t* sym) {
+    const elf_shdr_t* strtab = &m->sections[m->sections[m->symtab].sh_link];
+    if (sym->st_name >= strtab->sh_size) {
+        return 0;
+    }
+    const char* name = (const char*)(m->base + strtab->sh_offset + sym->st_name);
+    if (strnlen(name, strtab->sh_size - sym->st_name) == strtab->sh_size - sym->st_name) {
+        return 0;
+    }
+    return name;
+}
+
+// Find the entry point: the global symbol MODULE_ENTRY_SYMBOL, defined in
+// an allocated section
+// Returns: its address in the module view, or 0 if missing
+static unsigned long module_find_entry(const module_t* m) {
+    const elf_shdr_t* symtab = &m->sections[m->symtab];
+    const elf_sym_t* syms = (const elf_sym_t*)(m->base + symtab->sh_offset);
+    unsigned long count = symtab->sh_size / sizeof(elf_sym_t);
+    
+    for (unsigned long i = 1; i < count; i++) {
+        const elf_sym_t* sym = &syms[i];
+        if (ELF_SYM_BIND(sym->st_info) != ELF_STB_GLOBAL || sym->st_shndx == ELF_SHN_UNDEF ||
+            sym->st_shndx >= m->section_count) {
+            continue;
+        }
+        const char* name = module_symbol_name(m, sym);
+        if (name == 0 || strcmp(name, MODULE_ENTRY_SYMBOL) != 0) {
+            continue;
+        }
+        const elf_shdr_t* section = &m->sections[sym->st_shndx];
+        if (!(section->sh_flags & ELF_SHF_ALLOC) || sym->st_value >= section->sh_size) {
+            return 0;
+        }
+        return module_section_addr(m, sym->st_shndx) + sym->st_value;
+    }
+    return 0;
+}
+
+// Value of symbol index in the agent's view: module sections, absolute
+// values, or the ring-3 library for undefined symbols
+// Returns: 0 on success, -1 with *reason set otherwise
+static int module_symbol_value(const module_t* m, unsigned long index, unsigned long* value, const char** reason) {
+    const elf_shdr_t* symtab = &m->sections[m->symtab];
+    if (index == 0 || index >= symtab->sh_size / sizeof(elf_sym_t)) {
+        *reason = "bad symbol index";
+        return -1;
+    }
+    const elf_sym_t* sym = (const elf_sym_t*)(m->base + symtab->sh_offset) + index;
+    
+    if (sym->st_shndx == ELF_SHN_UNDEF) {
+        const char* name = module_symbol_name(m, sym);
+        for (unsigned int i = 0; name != 0 && i < MODULE_EXPORT_COUNT; i++) {
+            if (strcmp(name, module_exports[i].name) == 0) {
+                *value = module_exports[i].addr;
+                return 0;
+            }
+        }
+        *reason = "undefined symbol";
+        return -1;
+    }
+    if (sym->st_shndx == ELF_SHN_ABS) {
+        *value = sym->st_value;
+        return 0;
+    }
+    if (sym->st_shndx >= m->section_count || !(m->sections[sym->st_shndx].sh_flags & ELF_SHF_ALLOC)) {
+        *reason = "symbol outside the module";
+        return -1;
+    }
+    *value = module_section_addr(m, sym->st_shndx) + sym->st_value;
+    return 0;
+}
+
+// Apply one relocation at offset in section target; addend is 0 for REL
+// entries, whose addend is read from the place itself
+// Returns: 0 on success, -1 with *reason set otherwise
+static int module_apply(module_t* m, unsigned int target, unsigned long offset, unsigned long info,
+                        long addend, int in_place, const char** reason) {
+    unsigned long type = ELF_R_TYPE(info);
+    unsigned long width = sizeof(unsigned int);
+#if defined(__x86_64__)
+    if (type == ELF_R_64) {
+        width = sizeof(unsigned long);
+    }
+#endif
+    const elf_shdr_t* section = &m->sections[target];
+    if (offset > section->sh_size || width > section->sh_size - offset) {
+        *reason = "relocation outside its section";
+        return -1;
+    }
+    
+    unsigned long symbol;
+    if (module_symbol_value(m, ELF_R_SYM(info), &symbol, reason) != 0) {
+        return -1;
+    }
+    
+    // Written through the kernel map; the agent sees it at place
+    unsigned char* loc = m->base + section->sh_offset + offset;
+    unsigned long place = module_section_addr(m, target) + offset;
+    if (in_place) {
+        int implicit;
+        memcpy(&implicit, loc, sizeof(implicit));
+        addend = implicit;
+    }
+    
+    unsigned long value = symbol + (unsigned long)addend;
+    if (type == ELF_R_PC32 || type == ELF_R_PLT32) {
+        value -= place;
+    }
+    
+    switch (type) {
+#if defined(__x86_64__)
+        case ELF_R_64:
+            memcpy(loc, &value, sizeof(value));
+            return 0;
+        case ELF_R_32:
+            // Zero-extended into 64 bits
+            if (value > 0xFFFFFFFFUL) {
+                *reason = "relocation out of range";
+                return -1;
+            }
+            break;
+        case ELF_R_32S:
+        case ELF_R_PC32:
+        case ELF_R_PLT32:
+            // Sign-extended into 64 bits
+            if ((long)value != (int)value) {
+                *reason = "relocation out of range";
+                return -1;
+            }
+            break;
+#else
+        case ELF_R_32:
+        case ELF_R_PC32:
+        case ELF_R_PLT32:
+            break;
+#endif
+        default:
+            *reason = "unsupported relocation type";
+            return -1;
+    }
+    
+    unsigned int field = (unsigned int)value;
+    memcpy(loc, &field, sizeof(field));
+    return 0;
+}
+
+// Resolve every relocation against an allocated section, in place
+// Returns: number of relocations applied, or -1 with *reason set
+static int module_relocate(module_t* m, const char** reason) {
+    int applied = 0;
+    
+    for (unsigned int i = 1; i < m->section_count; i++) {
+        const elf_shdr_t* sh = &m->sections[i];
+        if (sh->sh_type != ELF_SHT_REL && sh->sh_type != ELF_SHT_RELA) {
+            continue;
+        }
+        // Relocations for debug sections are not needed to run
+        if (sh->sh_info == 0 || sh->sh_info >= m->section_count ||
+            !(m->sections[sh->sh_info].sh_flags & ELF_SHF_ALLOC)) {
+            continue;
+        }
+    
+        int rela = sh->sh_type == ELF_SHT_RELA;
+        unsigned long entry_size = rela ? sizeof(elf_rela_t) : sizeof(elf_rel_t);
+        if (sh->sh_link != m->symtab || sh->sh_entsize != entry_size ||
+            (sh->sh_offset & (sizeof(unsigned long) - 1)) != 0) {
+            *reason = "bad relocation section";
+            return -1;
+        }
+    
+        const unsigned char* entries = m->base + sh->sh_offset;
+        for (unsigned long offset = 0; offset + entry_size <= sh->sh_size; offset += entry_size) {
+            const elf_rela_t* rel = (const elf_rela_t*)(entries + offset);
+            long addend = rela ? rel->r_addend : 0;
+            if (module_apply(m, sh->sh_info, rel->r_offset, rel->r_info, addend, !rela, reason) != 0) {
+                return -1;
+            }
+            applied++;
+        }
+    }
+    return applied;
+}
+
+// Find the module an agent was loaded from
+static module_t* module_of_agent(int agent_id) {
+    for (unsigned int i = 0; i < module_total; i++) {
+        if (module_table[i].agent_id == agent_id) {
+            return &module_table[i];
+        }
+    }
+    return 0;
+}
+
+// Load step run by agent_run() before the module agent's first entry
+static int module_prepare(int agent_id) {
+    module_t* m = module_of_agent(agent_id);
+    if (m == 0) {
+        return -1;
+    }
+    if (m->relocated) {
+        return 0;
+    }
+    
+    char audit_msg[AUDIT_MSG_MAX];
+    const char* reason = "";
+    int applied = module_relocate(m, &reason);
+    if (applied < 0) {
+        ksnprintf(audit_msg, sizeof(audit_msg), "Module relocation failed: %s", reason);
+        audit_emit(AUDIT_TYPE_AGENT_ERROR, AUDIT_RESULT_FAILURE, agent_id, -1, audit_msg);
+        return -1;
+    }
+    m->relocated = 1;
+    
+    ksnprintf(audit_msg, sizeof(audit_msg), "Module relocated (%d relocations)", applied);
+    audit_emit(AUDIT_TYPE_AGENT_STARTED, AUDIT_RESULT_NONE, agent_id, -1, audit_msg);
+    return 0;
+}
+
+// Split a module command line into the agent name and an optional
+// capability mask (decimal or 0x-prefixed hex)
+// Returns: 0 on success, -1 if the name is missing or too long, or the mask is malformed
+static int module_parse_cmdline(const char* cmdline, char* name, cap_mask_t* caps) {
+    unsigned int len = 0;
+    while (*cmdline == ' ') {
+        cmdline++;
+    }
+    while (cmdline[len] != '\0' && cmdline[len] != ' ') {
+        if (len + 1 >= AGENT_NAME_MAX) {
+            return -1;
+        }
+        name[len] = cmdline[len];
+        len++;
+    }
+    name[len] = '\0';
+    if (len == 0) {
+        return -1;
+    }
+    
+    const char* p = cmdline + len;
+    while (*p == ' ') {
+        p++;
+    }
+    *caps = CAP_NONE;
+    if (*p == '\0') {
+        return 0;
+    }
+    
+    unsigned int base = 10;
+    if (p[0] == '0' && (p[1] == 'x' || p[1] == 'X')) {
+        base = 16;
+        p += 2;
+    }
+    int digits = 0;
+    for (; *p != '\0' && *p != ' '; p++, digits++) {
+        unsigned int digit;
+        if (*p >= '0' && *p <= '9') {
+            digit = (unsigned int)(*p - '0');
+        } else if (base == 16 && *p >= 'a' && *p <= 'f') {
+            digit = (unsigned int)(*p - 'a' + 10);
+        } else if (base == 16 && *p >= 'A' && *p <= 'F') {
+            digit = (unsigned int)(*p - 'A' + 10);
+        } else {
+            return -1;
+        }
+        if (digit >= base || *caps > (0xFFFFFFFFU - digit) / base) {
+            return -1;
+        }
+        *caps = *caps * base + digit;
+    }
+    return digits > 0 ? 0 : -1;
+}
+
+// Validate one boot module and register it as an agent
+// Returns: 0 on success, -1 on failure (audited)
+static int module_register(const multiboot_module_t* boot, unsigned int index) {
+    char audit_msg[AUDIT_MSG_MAX];
+    char name[AGENT_NAME_MAX];
+    cap_mask_t caps;
+    const char* reason = 0;
+    
+    module_t* m = &module_table[module_total];
+    m->base = (unsigned char*)boot->start;
+    m->size = boot->end - boot->start;
+    m->agent_id = -1;
+    m->relocated = 0;
+    
+    unsigned long entry = 0;
+    if (module_parse_cmdline(boot->cmdline, name, &caps) != 0) {
+        reason = "bad command line";
+    } else if ((boot->start & (PAGE_SIZE - 1)) != 0 || m->size > PAGING_MODULE_PAGES * PAGE_SIZE) {
+        reason = "misaligned or too large";
+    } else if (module_check(m, &reason) == 0 && (entry = module_find_entry(m)) == 0) {
+        reason = "no " MODULE_ENTRY_SYMBOL " function";
+    }
+    if (reason != 0) {
+        ksnprintf(audit_msg, sizeof(audit_msg), "Boot module %u rejected: %s", index, reason);
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, audit_msg);
+        return -1;
+    }
+    
+    int id = agent_create(name, (agent_entry_t)entry, 0);
+    if (id < 0) {
+        ksnprintf(audit_msg, sizeof(audit_msg), "Boot module %u rejected: no free agent slot", index);
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, audit_msg);
+        return -1;
+    }
+    m->agent_id = id;
+    
+    // Nothing is copied: the agent sees the module's own pages
+    unsigned int pages = (unsigned int)((m->size + PAGE_SIZE - 1) / PAGE_SIZE);
+    if (paging_map_module(id, m->base, pages) != 0 || agent_set_prepare(id, module_prepare) != 0 ||
+        (caps != CAP_NONE && cap_grant(id, caps) != 0)) {
+        // Give the slot back, with whatever part of the setup succeeded
+        agent_release(id);
+        m->agent_id = -1;
+        ksnprintf(audit_msg, sizeof(audit_msg), "Boot module %u rejected: setup failed", index);
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, id, -1, audit_msg);
+        return -1;
+    }
+    
+    ksnprintf(audit_msg, sizeof(audit_msg), "Boot module %u loaded in place (%lu bytes)", index, m->size);
+    audit_emit(AUDIT_TYPE_SYSTEM_INIT, AUDIT_RESULT_SUCCESS, id, -1, audit_msg);
+    module_total++;
+    return 0;
+}
+
+unsigned int module_load_all(void) {
+    module_total = 0;
+    for (unsigned int i = 0; i < multiboot_module_count() && module_total < MODULE_MAX; i++) {
+        module_register(multiboot_module(i), i);
+    }
+    return module_total;
+}
+
+unsigned int module_count(void) {
+    return module_total;
+}
+
+int module_agent(unsigned int index) {
+    if (index >= module_total) {
+        return -1;
+    }
+    return module_table[index].agent_id;
+}
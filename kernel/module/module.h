@@ -0,0 +1,35 @@
+// AgentOS Agent Module Loader
+// Week 3: GRUB-loaded ELF boot modules registered as agents, relocated lazily
+
+#ifndef MODULE_H
+#define MODULE_H
+
+#include "multiboot.h"             // For MULTIBOOT_MODULE_MAX
+
+// Maximum number of module agents (one per boot module)
+#define MODULE_MAX MULTIBOOT_MODULE_MAX
+
+// Global function every module defines: void agent_main(void* context)
+#define MODULE_ENTRY_SYMBOL "agent_main"
+
+// Register every boot module as an agent. A module is a relocatable ELF
+// object of the kernel's class (compiled like ring-3 agent code) listed on
+// a grub.cfg line "module2 <path> <agent name> [<capability mask>]".
+// It is used in place, never copied: its pages are mapped read-only at
+// PAGING_MODULE_VIEW in its agent's space, so it must have no writable or
+// zero-fill sections. Only the headers and the symbol table are read here;
+// relocations are resolved on the agent's first run (undefined symbols
+// against the ring-3 library in kernel/user/user.h), so boot time does not
+// grow with module code size.
+// Requires multiboot_init(), agent_init() and cap_init()
+// Returns: number of module agents registered (rejections are audited)
+unsigned int module_load_all(void);
+
+// Number of module agents registered
+unsigned int module_count(void);
+
+// Get the agent ID of a module agent (0 .. module_count() - 1, in grub.cfg order)
+// Returns: agent ID, or -1 if index is out of range
+int module_agent(unsigned int index);
+
+#endif // MODULE_H
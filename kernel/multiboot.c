@@ -0,0 +1,106 @@
+// AgentOS Multiboot2 Boot Information Implementation
+// Week 3: Boot modules and the kernel command line handed over by GRUB
+
+#include "multiboot.h"
+#include "arch/x86_64/paging.h"  // For PAGING_USER_BASE (end of the identity map)
+
+// Tag types used here (everything else is skipped)
+#define MULTIBOOT_TAG_END     0
+#define MULTIBOOT_TAG_CMDLINE 1
+#define MULTIBOOT_TAG_MODULE  3
+
+// Tags start 8-byte aligned
+#define MULTIBOOT_TAG_ALIGN 8
+
+// Fixed part of the boot information structure
+typedef struct {
+    unsigned int total_size;
+    unsigned int reserved;
+} multiboot_info_t;
+
+// Common tag header
+typedef struct {
+    unsigned int type;
+    unsigned int size;
+} multiboot_tag_t;
+
+// Module tag: header, physical bounds, then the null-terminated command line
+typedef struct {
+    unsigned int type;
+    unsigned int size;
+    unsigned int mod_start;
+    unsigned int mod_end;
+    char cmdline[];
+} multiboot_tag_module_t;
+
+static const char multiboot_empty[] = "";
+
+static const char* multiboot_cmdline_value = multiboot_empty;
+static multiboot_module_t multiboot_modules[MULTIBOOT_MODULE_MAX];
+static unsigned int multiboot_module_total = 0;
+
+// Check that a string lies within a tag (GRUB terminates it, but do not trust that)
+static int multiboot_string_ok(const char* s, unsigned int max) {
+    for (unsigned int i = 0; i < max; i++) {
+        if (s[i] == '\0') {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int multiboot_init(unsigned long magic, unsigned long info) {
+    if (magic != MULTIBOOT2_BOOTLOADER_MAGIC || info == 0 || (info & (MULTIBOOT_TAG_ALIGN - 1)) != 0) {
+        return -1;
+    }
+    
+    // The structure must lie in the kernel identity map
+    const multiboot_info_t* header = (const multiboot_info_t*)info;
+    if (info >= PAGING_USER_BASE || header->total_size < sizeof(multiboot_info_t) + sizeof(multiboot_tag_t) ||
+        header->total_size > PAGING_USER_BASE - info) {
+        return -1;
+    }
+    
+    unsigned long end = info + header->total_size;
+    unsigned long pos = info + sizeof(multiboot_info_t);
+    while (pos + sizeof(multiboot_tag_t) <= end) {
+        const multiboot_tag_t* tag = (const multiboot_tag_t*)pos;
+        if (tag->type == MULTIBOOT_TAG_END || tag->size < sizeof(multiboot_tag_t) || tag->size > end - pos) {
+            break;
+        }
+    
+        if (tag->type == MULTIBOOT_TAG_CMDLINE) {
+            const char* cmdline = (const char*)(tag + 1);
+            if (multiboot_string_ok(cmdline, tag->size - sizeof(multiboot_tag_t))) {
+                multiboot_cmdline_value = cmdline;
+            }
+        } else if (tag->type == MULTIBOOT_TAG_MODULE && tag->size > sizeof(multiboot_tag_module_t)) {
+            const multiboot_tag_module_t* module = (const multiboot_tag_module_t*)tag;
+            if (multiboot_module_total < MULTIBOOT_MODULE_MAX && module->mod_end >= module->mod_start &&
+                multiboot_string_ok(module->cmdline, tag->size - sizeof(multiboot_tag_module_t))) {
+                multiboot_module_t* out = &multiboot_modules[multiboot_module_total++];
+                out->start = module->mod_start;
+                out->end = module->mod_end;
+                out->cmdline = module->cmdline;
+            }
+        }
+    
+        pos += (tag->size + MULTIBOOT_TAG_ALIGN - 1) & ~(unsigned long)(MULTIBOOT_TAG_ALIGN - 1);
+    }
+    return 0;
+}
+
+const char* multiboot_cmdline(void) {
+    return multiboot_cmdline_value;
+}
+
+unsigned int multiboot_module_count(void) {
+    return multiboot_module_total;
+}
+
+const multiboot_module_t* multiboot_module(unsigned int index) {
+    if (index >= multiboot_module_total) {
+        return 0;
+    }
+    return &multiboot_modules[index];
+}
@@ -0,0 +1,38 @@
+// AgentOS Multiboot2 Boot Information
+// Week 3: Boot modules and the kernel command line handed over by GRUB
+
+#ifndef MULTIBOOT_H
+#define MULTIBOOT_H
+
+// Value GRUB leaves in eax for a Multiboot2 kernel (passed to kernel_main())
+#define MULTIBOOT2_BOOTLOADER_MAGIC 0x36d76289
+
+// Boot modules remembered (module2 lines in grub.cfg); later ones are ignored
+#define MULTIBOOT_MODULE_MAX 16
+
+// One boot module, left by GRUB in identity-mapped memory
+typedef struct {
+    unsigned long start;         // Physical (= kernel) address of the first byte
+    unsigned long end;           // Address after the last byte
+    const char* cmdline;         // Text after the path on its module2 line ("" if none)
+} multiboot_module_t;
+
+// Walk the boot information structure at info (read in place, nothing
+// copied) and record the command line and module tags
+// Needs no other module, so it can run first in kernel_main()
+// Returns: 0 on success, -1 if magic is wrong or info is invalid (then
+// there are no modules and the command line is empty)
+int multiboot_init(unsigned long magic, unsigned long info);
+
+// Kernel command line (text after the kernel path on the multiboot2 line)
+// Returns: null-terminated string, "" if none
+const char* multiboot_cmdline(void);
+
+// Number of boot modules recorded
+unsigned int multiboot_module_count(void);
+
+// Get a boot module by index (0 .. multiboot_module_count() - 1, in grub.cfg order)
+// Returns: pointer to the module, or 0 if index is out of range
+const multiboot_module_t* multiboot_module(unsigned int index);
+
+#endif // MULTIBOOT_H
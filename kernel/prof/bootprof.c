@@ -0,0 +1,112 @@
+// AgentOS Boot-Phase Profiler Implementation
+// Week 3: TSC timeline of kernel_main() phases, from GRUB handoff to the first agent
+
+#include "bootprof.h"
+#include "clock/clock.h"
+#include "console/console.h"
+#include "serial.h"
+#include "vga.h"
+#include "lib/format.h"
+
+// One closed phase: its name and the TSC at its end
+typedef struct {
+    const char* name;
+    unsigned long long end;
+} bootprof_phase_t;
+
+// Timeline (fixed-size, no heap; starts zeroed in BSS)
+static bootprof_phase_t bootprof_phases[BOOTPROF_MAX_PHASES];
+static unsigned int bootprof_count = 0;
+static unsigned int bootprof_dropped = 0;
+
+// TSC when the first agent entered ring 3 (0 until then)
+static unsigned long long bootprof_first_agent = 0;
+
+// Cycles before the first agent that are not boot work (bootprof_exclude())
+static unsigned long long bootprof_excluded = 0;
+
+// Convert a cycle count to microseconds at the calibrated rate
+static unsigned int bootprof_us(unsigned long long cycles) {
+    return (unsigned int)clock_div64(cycles * 1000, clock_cycles_per_ms());
+}
+
+void bootprof_mark(const char* phase) {
+    unsigned long long now = clock_cycles();
+    if (bootprof_count >= BOOTPROF_MAX_PHASES) {
+        bootprof_dropped++;
+        return;
+    }
+    bootprof_phases[bootprof_count].name = phase;
+    bootprof_phases[bootprof_count].end = now;
+    bootprof_count++;
+}
+
+void bootprof_agent_entry(void) {
+    if (bootprof_first_agent == 0) {
+        bootprof_first_agent = clock_cycles();
+    }
+}
+
+void bootprof_exclude(unsigned long long cycles) {
+    if (bootprof_first_agent == 0) {
+        bootprof_excluded += cycles;
+    }
+}
+
+unsigned long long bootprof_first_agent_cycles(void) {
+    if (bootprof_first_agent == 0) {
+        return 0;
+    }
+    return bootprof_first_agent - clock_boot_cycles() - bootprof_excluded;
+}
+
+void bootprof_dump_to_console(void) {
+    char line[VGA_WIDTH];  // At most VGA_WIDTH - 1 characters, so lines never auto-wrap
+    
+    console_batch_begin();
+    console_write(CONSOLE_KERNEL, "Boot timeline (us since GRUB handoff):\n");
+    
+    // One line per phase: " audit            +12 us  @345"
+    unsigned long long start = clock_boot_cycles();
+    for (unsigned int i = 0; i < bootprof_count; i++) {
+        const bootprof_phase_t* phase = &bootprof_phases[i];
+        ksnprintf(line, VGA_WIDTH, " %-20s +%u us  @%u", phase->name,
+                  bootprof_us(phase->end - start), bootprof_us(phase->end - clock_boot_cycles()));
+        console_write(CONSOLE_KERNEL, line);
+        console_write(CONSOLE_KERNEL, "\n");
+        start = phase->end;
+    }
+    
+    ksnprintf(line, VGA_WIDTH, " first agent at %u us (%u phases dropped)",
+              bootprof_us(bootprof_first_agent_cycles()), bootprof_dropped);
+    console_write(CONSOLE_KERNEL, line);
+    console_write(CONSOLE_KERNEL, "\n");
+    console_batch_end();
+}
+
+void bootprof_export_serial(void) {
+    char line[96];
+    
+    ksnprintf(line, sizeof(line), "BOOT-BEGIN phases=%u dropped=%u cycles_per_ms=%u\n",
+              bootprof_count, bootprof_dropped, clock_cycles_per_ms());
+    serial_write(line);
+    
+    unsigned long long start = clock_boot_cycles();
+    for (unsigned int i = 0; i < bootprof_count; i++) {
+        const bootprof_phase_t* phase = &bootprof_phases[i];
+        ksnprintf(line, sizeof(line), "BOOT %s %u %u\n", phase->name,
+                  bootprof_us(start - clock_boot_cycles()), bootprof_us(phase->end - start));
+        serial_write(line);
+        start = phase->end;
+    }
+    
+    ksnprintf(line, sizeof(line), "BOOT-FIRST-AGENT %u\n", bootprof_us(bootprof_first_agent_cycles()));
+    serial_write(line);
+    serial_write("BOOT-END\n");
+}
+
+void bootprof_bench(void) {
+    char line[64];
+    ksnprintf(line, sizeof(line), "BENCH boot_to_first_agent %u us\n", bootprof_us(bootprof_first_agent_cycles()));
+    serial_write(line);
+}
@@ -0,0 +1,41 @@
+// AgentOS Boot-Phase Profiler
+// Week 3: TSC timeline of kernel_main() phases, from GRUB handoff to the first agent
+
+#ifndef BOOTPROF_H
+#define BOOTPROF_H
+
+// Phases recorded per boot (marks beyond this are counted as dropped)
+#define BOOTPROF_MAX_PHASES 32
+
+// Close the current boot phase: it is named phase and ran from the previous
+// mark (or from the GRUB handoff, for the first one) to now
+// Only reads the TSC, so it may run before clock_init() and serial_init();
+// phase must be a string literal (the pointer is kept)
+void bootprof_mark(const char* phase);
+
+// Record that an agent is entering ring 3; the first call of the boot
+// ends the handoff-to-first-agent interval (called by agent_run())
+void bootprof_agent_entry(void);
+
+// Leave cycles spent on work that is not part of booting (benchmarks that
+// run before the first agent) out of the handoff-to-first-agent interval;
+// ignored once an agent has run. The phase timeline still shows them
+void bootprof_exclude(unsigned long long cycles);
+
+// Cycles from the GRUB handoff to the first agent entering ring 3, less
+// the cycles passed to bootprof_exclude()
+// Returns: 0 if no agent has run yet
+unsigned long long bootprof_first_agent_cycles(void);
+
+// Print the timeline (per-phase and cumulative microseconds) to the kernel console
+void bootprof_dump_to_console(void);
+
+// Write the timeline to serial between BOOT-BEGIN/BOOT-END markers:
+// "BOOT <phase> <start us> <duration us>" per phase, then
+// "BOOT-FIRST-AGENT <us>"
+void bootprof_export_serial(void);
+
+// Write the handoff-to-first-agent time as a BENCH line to serial
+void bootprof_bench(void);
+
+#endif // BOOTPROF_H
@@ -0,0 +1,114 @@
+// AgentOS Sampling Profiler Implementation
+// Week 3: Timer-interrupt EIP/EBP-chain sampling, exported over serial
+
+#include "prof.h"
+#include "timer/timer.h"
+#include "serial.h"
+#include "audit/audit.h"
+#include "lib/format.h"
+
+// One stack sample: pcs[0] is the interrupted EIP, the rest are return addresses
+typedef struct {
+    unsigned int depth;
+    unsigned long pcs[PROF_STACK_DEPTH];
+} prof_sample_t;
+
+// Kernel stack bounds exported by entry.S
+extern char stack_bottom[];
+extern char stack_top[];
+
+// Sample buffer (preallocated, no heap)
+static prof_sample_t prof_samples[PROF_MAX_SAMPLES];
+static volatile unsigned int prof_sample_count = 0;
+static volatile unsigned int prof_dropped = 0;
+
+// Sampling flag (read by the tick handler)
+static volatile int prof_active = 0;
+
+// Check that a frame pointer lies inside the kernel stack
+static int prof_frame_valid(unsigned long fp) {
+    unsigned long lo = (unsigned long)stack_bottom;
+    unsigned long hi = (unsigned long)stack_top;
+    return (fp & (sizeof(unsigned long) - 1)) == 0 && fp >= lo && fp + 2 * sizeof(unsigned long) <= hi;
+}
+
+// Timer tick handler: record EIP and walk the saved-EBP chain
+static void prof_tick(interrupt_frame_t* frame) {
+    if (!prof_active) {
+        return;
+    }
+    if (prof_sample_count >= PROF_MAX_SAMPLES) {
+        prof_dropped++;
+        return;
+    }
+    
+    prof_sample_t* sample = &prof_samples[prof_sample_count];
+    unsigned int depth = 0;
+    sample->pcs[depth++] = INTERRUPT_FRAME_PC(frame);
+    
+    // Kernel is built without -fomit-frame-pointer: [fp] = caller fp, [fp+word] = return address
+    unsigned long frame_ptr = INTERRUPT_FRAME_FP(frame);
+    while (depth < PROF_STACK_DEPTH && prof_frame_valid(frame_ptr)) {
+        const unsigned long* fp = (const unsigned long*)frame_ptr;
+        unsigned long ret = fp[1];
+        if (ret == 0) {
+            break;
+        }
+        sample->pcs[depth++] = ret;
+        if (fp[0] <= frame_ptr) {
+            break;  // Frames must move toward the stack top
+        }
+        frame_ptr = fp[0];
+    }
+    
+    sample->depth = depth;
+    prof_sample_count++;
+}
+
+void prof_init(void) {
+    prof_active = 0;
+    prof_sample_count = 0;
+    prof_dropped = 0;
+    
+    if (timer_register_tick(prof_tick) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register profiler tick");
+    }
+}
+
+void prof_start(void) {
+    prof_active = 0;
+    prof_sample_count = 0;
+    prof_dropped = 0;
+    prof_active = 1;
+}
+
+void prof_stop(void) {
+    prof_active = 0;
+}
+
+int prof_running(void) {
+    return prof_active;
+}
+
+void prof_dump_serial(void) {
+    char line[16 + PROF_STACK_DEPTH * (2 * sizeof(unsigned long) + 1)];
+    
+    // Header: "PROF-BEGIN hz=<hex> samples=<hex> dropped=<hex>"
+    ksnprintf(line, sizeof(line), "PROF-BEGIN hz=%08x samples=%08x dropped=%08x\n",
+              timer_hz(), prof_sample_count, prof_dropped);
+    serial_write(line);
+    
+    // Samples: "S <eip> <ret1> <ret2> ..." (innermost first, hex)
+    unsigned int count = prof_sample_count;
+    for (unsigned int n = 0; n < count; n++) {
+        const prof_sample_t* sample = &prof_samples[n];
+        unsigned int pos = ksnprintf(line, sizeof(line), "S");
+        for (unsigned int d = 0; d < sample->depth; d++) {
+            pos += ksnprintf(line + pos, sizeof(line) - pos, " %08lx", sample->pcs[d]);
+        }
+        ksnprintf(line + pos, sizeof(line) - pos, "\n");
+        serial_write(line);
+    }
+    
+    serial_write("PROF-END\n");
+}
@@ -0,0 +1,30 @@
+// AgentOS Sampling Profiler
+// Week 3: Timer-interrupt EIP/EBP-chain sampling, exported over serial
+
+#ifndef PROF_H
+#define PROF_H
+
+// Preallocated sample capacity (samples beyond this are counted as dropped)
+#define PROF_MAX_SAMPLES 4096
+
+// Maximum frames per sample (interrupted EIP + return addresses)
+#define PROF_STACK_DEPTH 8
+
+// Hook the profiler into the timer tick (sampling starts stopped)
+void prof_init(void);
+
+// Clear previous samples and start sampling on every timer tick
+void prof_start(void);
+
+// Stop sampling (samples are kept until the next prof_start())
+void prof_stop(void);
+
+// Check whether the profiler is sampling
+// Returns: 1 if running, 0 otherwise
+int prof_running(void);
+
+// Write all samples to serial between PROF-BEGIN/PROF-END markers
+// Fold against build/kernel.elf with tools/prof2folded.py
+void prof_dump_serial(void);
+
+#endif // PROF_H
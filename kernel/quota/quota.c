@@ -0,0 +1,128 @@
+// AgentOS Intent Quota Module Implementation
+// Week 3: Per-(agent, intent action) token-bucket admission control
+
+#include "quota.h"
+#include "agent/agent.h"    // For AGENT_MAX_COUNT
+#include "intent/intent.h"  // For INTENT_MAX
+#include "clock/clock.h"
+#include "lib/format.h"
+
+// Token bucket state
+// Tokens are stored as TSC cycles of credit: the bucket refills at one cycle
+// per elapsed cycle and each admitted intent costs `interval` cycles, so the
+// hot path needs only a TSC read, 64-bit adds and compares (no division).
+typedef struct {
+    unsigned long long interval;  // Cycles per token (0 = unlimited)
+    unsigned long long capacity;  // Bucket size in cycles (burst * interval)
+    unsigned long long credit;    // Accumulated credit in cycles
+    unsigned long long last;      // TSC value at last refill
+    unsigned int suppressed;      // Throttled submissions not yet audited
+    int throttled;                // 1 while in a throttle episode
+} quota_bucket_t;
+
+// Token buckets for each (agent, intent action) pair (fixed-size, no heap)
+static quota_bucket_t quota_table[AGENT_MAX_COUNT][INTENT_MAX];
+
+// Initialization flag
+static int quota_initialized = 0;
+
+void quota_init(void) {
+    // Every pair starts unlimited: a zeroed (BSS) entry has no interval
+    quota_initialized = 1;
+}
+
+int quota_set(agent_id_t agent_id, audit_intent_action_t action, const quota_t* quota) {
+    // Check if initialized
+    if (!quota_initialized) {
+        return -1;
+    }
+    
+    // Validate agent ID and action
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    if (action < 0 || action >= INTENT_MAX) {
+        return -1;
+    }
+    
+    quota_bucket_t* bucket = &quota_table[agent_id][action];
+    
+    // Remove the limit
+    if (quota == 0 || quota->rate == 0) {
+        bucket->interval = 0;
+        bucket->capacity = 0;
+        bucket->credit = 0;
+        bucket->throttled = 0;
+        bucket->suppressed = 0;
+        return 0;
+    }
+    
+    unsigned int burst = quota->burst == 0 ? 1 : quota->burst;
+    unsigned long long cycles_per_sec = (unsigned long long)clock_cycles_per_ms() * 1000;
+    unsigned long long interval = clock_div64(cycles_per_sec, quota->rate);
+    if (interval == 0) {
+        interval = 1;
+    }
+    
+    // Start with a full bucket
+    bucket->interval = interval;
+    bucket->capacity = interval * burst;
+    bucket->credit = bucket->capacity;
+    bucket->last = clock_cycles();
+    bucket->throttled = 0;
+    bucket->suppressed = 0;
+    
+    return 0;
+}
+
+int quota_admit(agent_id_t agent_id, audit_intent_action_t action) {
+    // Unconfigured pairs and invalid arguments are not rate limited here
+    // (argument validation belongs to the syscall layer)
+    if (!quota_initialized) {
+        return 1;
+    }
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT || action < 0 || action >= INTENT_MAX) {
+        return 1;
+    }
+    
+    quota_bucket_t* bucket = &quota_table[agent_id][action];
+    if (bucket->interval == 0) {
+        return 1;
+    }
+    
+    // Refill with elapsed cycles, capped at bucket capacity
+    unsigned long long now = clock_cycles();
+    unsigned long long elapsed = now - bucket->last;
+    bucket->last = now;
+    if (elapsed >= bucket->capacity - bucket->credit) {
+        bucket->credit = bucket->capacity;
+    } else {
+        bucket->credit += elapsed;
+    }
+    
+    if (bucket->credit < bucket->interval) {
+        // Throttled: audit only the first overrun of an episode
+        if (!bucket->throttled) {
+            bucket->throttled = 1;
+            bucket->suppressed = 0;
+            audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_THROTTLE, agent_id, action, "Intent rate limit exceeded");
+        } else {
+            bucket->suppressed++;
+        }
+        return 0;
+    }
+    
+    bucket->credit -= bucket->interval;
+    
+    // Close a throttle episode with a single summary record
+    if (bucket->throttled) {
+        char audit_msg[64];
+        ksnprintf(audit_msg, 64, "Rate limit cleared, further throttled: %u", bucket->suppressed);
+        
+        bucket->throttled = 0;
+        bucket->suppressed = 0;
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_THROTTLE, agent_id, action, audit_msg);
+    }
+    
+    return 1;
+}
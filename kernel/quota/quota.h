@@ -0,0 +1,33 @@
+// AgentOS Intent Quota Module
+// Week 3: Per-(agent, intent action) token-bucket admission control
+
+#ifndef QUOTA_H
+#define QUOTA_H
+
+#include "audit/audit.h"  // For agent_id_t and audit_intent_action_t
+
+// Quota configuration for one (agent, intent action) pair
+// rate == 0 means unlimited (no admission control)
+typedef struct {
+    unsigned int rate;   // Sustained intents per second
+    unsigned int burst;  // Maximum intents admitted back-to-back (minimum 1)
+} quota_t;
+
+// Initialize the quota system (all pairs unlimited)
+// Requires clock_init() to have calibrated the TSC
+void quota_init(void);
+
+// Configure the token bucket for an (agent, intent action) pair
+// Passing a quota with rate 0 (or a null pointer) removes the limit
+// Returns: 0 on success, -1 on failure (invalid agent_id or action)
+int quota_set(agent_id_t agent_id, audit_intent_action_t action, const quota_t* quota);
+
+// Charge one token for an intent submission
+// The first throttled submission of an episode is audited with a THROTTLE
+// result; further throttled submissions are only counted, and the count is
+// audited once when the bucket admits again, so a flooding agent cannot evict
+// the audit ring.
+// Returns: 1 if admitted, 0 if throttled
+int quota_admit(agent_id_t agent_id, audit_intent_action_t action);
+
+#endif // QUOTA_H
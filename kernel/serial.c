@@ -0,0 +1,54 @@
+// AgentOS Serial Port Output Implementation
+// Week 3: Polled COM1 output for machine-readable exports
+
+#include "serial.h"
+#include "arch/x86_64/io.h"
+
+// COM1 base I/O port
+#define SERIAL_COM1 0x3F8
+
+// Register offsets from the base port
+#define SERIAL_DATA        0  // Data register (DLAB=0) / divisor low (DLAB=1)
+#define SERIAL_INT_ENABLE  1  // Interrupt enable (DLAB=0) / divisor high (DLAB=1)
+#define SERIAL_FIFO_CTRL   2  // FIFO control
+#define SERIAL_LINE_CTRL   3  // Line control
+#define SERIAL_MODEM_CTRL  4  // Modem control
+#define SERIAL_LINE_STATUS 5  // Line status
+
+// Line status: transmit holding register empty
+#define SERIAL_LSR_THR_EMPTY 0x20
+
+// Initialization flag
+static int serial_initialized = 0;
+
+void serial_init(void) {
+    outb(SERIAL_COM1 + SERIAL_INT_ENABLE, 0x00);  // Disable UART interrupts
+    outb(SERIAL_COM1 + SERIAL_LINE_CTRL, 0x80);   // Enable DLAB to set divisor
+    outb(SERIAL_COM1 + SERIAL_DATA, 0x01);        // Divisor 1 = 115200 baud
+    outb(SERIAL_COM1 + SERIAL_INT_ENABLE, 0x00);
+    outb(SERIAL_COM1 + SERIAL_LINE_CTRL, 0x03);   // 8 bits, no parity, 1 stop bit
+    outb(SERIAL_COM1 + SERIAL_FIFO_CTRL, 0xC7);   // Enable and clear FIFOs, 14-byte threshold
+    outb(SERIAL_COM1 + SERIAL_MODEM_CTRL, 0x03);  // DTR + RTS
+    
+    serial_initialized = 1;
+}
+
+// Write a single byte once the transmitter is ready
+static void serial_putchar(char c) {
+    while ((inb(SERIAL_COM1 + SERIAL_LINE_STATUS) & SERIAL_LSR_THR_EMPTY) == 0) {
+    }
+    outb(SERIAL_COM1 + SERIAL_DATA, (unsigned char)c);
+}
+
+void serial_write(const char* s) {
+    if (!serial_initialized || s == 0) {
+        return;
+    }
+    
+    for (unsigned int i = 0; s[i] != '\0'; i++) {
+        if (s[i] == '\n') {
+            serial_putchar('\r');
+        }
+        serial_putchar(s[i]);
+    }
+}
@@ -0,0 +1,14 @@
+// AgentOS Serial Port Output
+// Week 3: Polled COM1 output for machine-readable exports
+
+#ifndef SERIAL_H
+#define SERIAL_H
+
+// Initialize COM1 (115200 baud, 8N1, FIFO enabled)
+void serial_init(void);
+
+// Write a null-terminated string to COM1 (polled)
+// '\n' is sent as "\r\n"
+void serial_write(const char* s);
+
+#endif // SERIAL_H
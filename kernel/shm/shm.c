@@ -0,0 +1,126 @@
+// AgentOS Shared Memory Module Implementation
+// Week 3: Capability-guarded shared memory regions for bulk zero-copy data between agents
+
+#include "shm.h"
+#include "lib/string.h"
+
+// Backing memory (fixed-size, no allocator): 4 KiB pages handed out in order,
+// and one large page aligned for a single directory entry
+static unsigned char shm_pool[SHM_POOL_PAGES][PAGE_SIZE] __attribute__((aligned(PAGE_SIZE)));
+static unsigned char shm_huge_page[PAGING_LARGE_PAGE_SIZE] __attribute__((aligned(PAGING_LARGE_PAGE_SIZE)));
+
+// Every page-granular region slot must fit the shared area
+typedef char shm_views_fit[(SHM_HUGE_REGION * SHM_REGION_MAX_PAGES <= PAGING_REGION_PAGES) ? 1 : -1];
+
+// Region table entry
+typedef struct {
+    int in_use;
+    int owner;                   // Creating agent
+    unsigned char* base;         // Kernel (identity-mapped) address
+    unsigned int pages;          // 4 KiB pages (0 for the huge region)
+    unsigned int mapped;         // Agents it is mapped into (1 << agent ID)
+} shm_region_t;
+
+static shm_region_t shm_table[SHM_MAX];
+
+// Next unused page in shm_pool
+static unsigned int shm_pool_next = 0;
+
+void shm_init(void) {
+    for (unsigned int i = 0; i < SHM_MAX; i++) {
+        shm_table[i].in_use = 0;
+        shm_table[i].owner = -1;
+        shm_table[i].base = 0;
+        shm_table[i].pages = 0;
+        shm_table[i].mapped = 0;
+    }
+    shm_pool_next = 0;
+}
+
+// Install a region's pages in an agent's space
+static int shm_install(shm_region_t* region, int agent_id, int writable) {
+    if (region->pages == 0) {
+        return paging_map_user_large(agent_id, region->base, writable);
+    }
+    return paging_map_user(agent_id, SHM_VIEW(region - shm_table), region->base, region->pages, writable);
+}
+
+int shm_create(int owner_id, unsigned int pages, int huge) {
+    if (owner_id < 0 || owner_id >= AGENT_MAX_COUNT || !cap_has(owner_id, CAP_SHM)) {
+        return -1;
+    }
+    
+    int id = -1;
+    if (huge) {
+        if (!shm_table[SHM_HUGE_REGION].in_use) {
+            id = SHM_HUGE_REGION;
+            shm_table[id].base = shm_huge_page;
+            shm_table[id].pages = 0;
+        }
+    } else if (pages != 0 && pages <= SHM_REGION_MAX_PAGES && pages <= SHM_POOL_PAGES - shm_pool_next) {
+        for (int i = 0; i < SHM_HUGE_REGION; i++) {
+            if (!shm_table[i].in_use) {
+                id = i;
+                break;
+            }
+        }
+        if (id >= 0) {
+            shm_table[id].base = shm_pool[shm_pool_next];
+            shm_table[id].pages = pages;
+            shm_pool_next += pages;
+        }
+    }
+    if (id < 0) {
+        return -1;
+    }
+    
+    shm_region_t* region = &shm_table[id];
+    memset(region->base, 0, region->pages == 0 ? PAGING_LARGE_PAGE_SIZE : region->pages * PAGE_SIZE);
+    region->in_use = 1;
+    region->owner = owner_id;
+    region->mapped = 0;
+    
+    if (cap_region_grant(-1, owner_id, (unsigned int)id, CAP_REGION_READ | CAP_REGION_WRITE) != 0 ||
+        shm_install(region, owner_id, 1) != 0) {
+        region->in_use = 0;
+        return -1;
+    }
+    region->mapped |= 1U << owner_id;
+    return id;
+}
+
+int shm_map(int from_id, int region_id, int to_id, unsigned int rights) {
+    if (region_id < 0 || region_id >= SHM_MAX || !shm_table[region_id].in_use) {
+        return -1;
+    }
+    if (to_id < 0 || to_id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    
+    // One mapping per agent; rights cannot be changed by mapping again
+    shm_region_t* region = &shm_table[region_id];
+    if (region->mapped & (1U << to_id)) {
+        return -1;
+    }
+    
+    if (cap_region_grant(from_id, to_id, (unsigned int)region_id, rights) != 0) {
+        return -1;
+    }
+    if (shm_install(region, to_id, (rights & CAP_REGION_WRITE) != 0) != 0) {
+        return -1;
+    }
+    region->mapped |= 1U << to_id;
+    return 0;
+}
+
+void shm_release(int agent_id) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT) {
+        return;
+    }
+    for (unsigned int i = 0; i < SHM_MAX; i++) {
+        shm_table[i].mapped &= ~(1U << agent_id);
+        if (shm_table[i].owner == agent_id) {
+            shm_table[i].owner = -1;
+        }
+    }
+}
@@ -0,0 +1,49 @@
+// AgentOS Shared Memory Module
+// Week 3: Capability-guarded shared memory regions for bulk zero-copy data between agents
+
+#ifndef SHM_H
+#define SHM_H
+
+#include "cap/cap.h"              // For CAP_REGION_*
+#include "arch/x86_64/paging.h"   // For PAGE_SIZE, PAGING_REGION_BASE, PAGING_HUGE_VIEW
+
+// Maximum number of regions (region ID = index into the cap.c rights table)
+#define SHM_MAX CAP_REGION_MAX
+
+// The last region ID is the huge region: one PAGING_LARGE_PAGE_SIZE page
+// mapped with a single directory entry at PAGING_HUGE_VIEW
+#define SHM_HUGE_REGION (SHM_MAX - 1)
+
+// Largest page-granular region, and the pool all of them are carved from
+#define SHM_REGION_MAX_PAGES 16
+#define SHM_POOL_PAGES 64
+
+// Where a region is mapped; the same address in every agent that maps it
+#define SHM_VIEW(region) \
+    ((region) == SHM_HUGE_REGION ? PAGING_HUGE_VIEW \
+                                 : PAGING_REGION_BASE + (unsigned long)(region) * SHM_REGION_MAX_PAGES * PAGE_SIZE)
+
+// Initialize the region table (no regions, empty pool)
+void shm_init(void);
+
+// Create a zeroed region owned by owner_id and map it read/write into the
+// owner (pages 4 KiB pages, or the huge region if huge is set)
+// The owner gets read/write rights through cap_region_grant()
+// Returns: region ID on success, -1 on failure (no CAP_SHM, bad size, pool
+// exhausted, or no free region)
+int shm_create(int owner_id, unsigned int pages, int huge);
+
+// Map a region into to_id with rights (CAP_REGION_READ, optionally
+// CAP_REGION_WRITE), on behalf of from_id, who must hold those rights
+// Checked and audited once here through cap_region_grant(); accesses
+// through the mapping are not checked again
+// Returns: 0 on success, -1 on failure (invalid region, not permitted, or
+// already mapped into to_id)
+int shm_map(int from_id, int region_id, int to_id, unsigned int rights);
+
+// Forget agent_id's mappings of every region, so a freed agent slot can map
+// them afresh (agent_release(); the pages go with its address space and the
+// rights with cap_clear()). Regions stay allocated for their other agents
+void shm_release(int agent_id);
+
+#endif // SHM_H
@@ -0,0 +1,462 @@
+// AgentOS Snapshot Module Implementation
+// Week 3: Versioned, incremental checkpoints of kernel tables on disk for warm boots
+
+#include "snapshot.h"
+#include "ata.h"
+#include "serial.h"
+#include "audit/audit.h"
+#include "clock/clock.h"
+#include "lib/string.h"
+#include "lib/format.h"
+#include "arch/x86_64/idt.h"  // For interrupts_save/restore
+
+// Sectors the section data may span
+#define SNAPSHOT_DATA_SECTORS (SNAPSHOT_DATA_MAX / ATA_SECTOR_SIZE)
+
+// Dirty bitmap words (one bit per data sector)
+#define SNAPSHOT_DIRTY_WORDS ((SNAPSHOT_DATA_SECTORS + 31) / 32)
+
+// Section alignment within the data area
+#define SNAPSHOT_ALIGN 8
+
+// Section directory entry (on disk)
+typedef struct {
+    unsigned int id;
+    unsigned int offset;         // Byte offset in the data area
+    unsigned int size;
+    unsigned int checksum;       // FNV-1a over the section bytes
+} snapshot_entry_t;
+
+// Header sector (on disk); everything before checksum is covered by it
+typedef struct {
+    unsigned int magic;          // SNAPSHOT_MAGIC
+    unsigned int version;        // SNAPSHOT_VERSION
+    unsigned int build_id;       // Kernel build and layout fingerprint
+    unsigned int generation;     // Checkpoints written to this disk
+    unsigned int data_size;      // Bytes of section data after the header sector
+    unsigned int section_count;
+    snapshot_entry_t sections[SNAPSHOT_SECTION_MAX];
+    unsigned int checksum;
+} snapshot_header_t;
+
+typedef char snapshot_header_fits[sizeof(snapshot_header_t) <= ATA_SECTOR_SIZE ? 1 : -1];
+
+// Registered section
+typedef struct {
+    unsigned char* base;         // 0 if not registered
+    unsigned int size;
+    unsigned int offset;         // Assigned by snapshot_init()
+    unsigned int checksum;       // Of the contents last written or restored
+    unsigned int config;         // Hash of the settings from snapshot_config()
+    snapshot_restoring_t restoring;
+    snapshot_restored_t restored;
+} snapshot_slot_t;
+
+static snapshot_slot_t snapshot_sections[SNAPSHOT_SECTION_MAX];
+
+// Data sectors changed since the last checkpoint
+static volatile unsigned int snapshot_dirty_map[SNAPSHOT_DIRTY_WORDS];
+
+// Mirror of the data area: sections are gathered here before a checkpoint
+// writes them, and a restore reads the whole area here before validating it
+static unsigned char snapshot_staging[SNAPSHOT_DATA_MAX] __attribute__((aligned(ATA_SECTOR_SIZE)));
+
+// Header sector buffer
+static union {
+    snapshot_header_t header;
+    unsigned char sector[ATA_SECTOR_SIZE];
+} snapshot_disk_header;
+
+static unsigned int snapshot_data_size = 0;
+static unsigned int snapshot_build_id = 0;
+static unsigned int snapshot_generation_value = 0;
+static int snapshot_laid_out = 0;
+static int snapshot_disk_ok = 0;
+
+// Kernel code and constants, and the ring-3 image (boot/linker.ld): the
+// tables point into both, so their contents identify the build
+extern char __kernel_text_start[];
+extern char __kernel_rodata_end[];
+extern char __user_load_start[];
+extern char __user_load_end[];
+
+// FNV-1a, continuing from hash
+static unsigned int snapshot_hash(unsigned int hash, const void* data, unsigned int len) {
+    const unsigned char* bytes = (const unsigned char*)data;
+    for (unsigned int i = 0; i < len; i++) {
+        hash = (hash ^ bytes[i]) * 16777619U;
+    }
+    return hash;
+}
+
+#define SNAPSHOT_HASH_SEED 2166136261U
+
+// FNV-1a a word at a time over an image with a page-aligned start,
+// continuing from hash (runs over the whole image every boot, so a quarter
+// of the steps); the last partial word goes byte by byte
+static unsigned int snapshot_hash_image(unsigned int hash, const char* start, const char* end) {
+    unsigned long words = (unsigned long)(end - start) / sizeof(unsigned int);
+    const unsigned int* word = (const unsigned int*)start;
+    for (unsigned long i = 0; i < words; i++) {
+        hash = (hash ^ word[i]) * 16777619U;
+    }
+    const char* tail = start + words * sizeof(unsigned int);
+    return snapshot_hash(hash, tail, (unsigned int)(end - tail));
+}
+
+int snapshot_register(snapshot_section_t section, void* base, unsigned int size, snapshot_restored_t restored) {
+    if ((unsigned int)section >= SNAPSHOT_SECTION_MAX || base == 0 || size == 0 || snapshot_laid_out) {
+        return -1;
+    }
+    if (snapshot_sections[section].base != 0) {
+        return -1;
+    }
+    
+    snapshot_sections[section].base = (unsigned char*)base;
+    snapshot_sections[section].size = size;
+    snapshot_sections[section].config = SNAPSHOT_HASH_SEED;
+    snapshot_sections[section].restoring = 0;
+    snapshot_sections[section].restored = restored;
+    return 0;
+}
+
+int snapshot_config(snapshot_section_t section, const void* config, unsigned int size) {
+    if ((unsigned int)section >= SNAPSHOT_SECTION_MAX || config == 0 || snapshot_laid_out) {
+        return -1;
+    }
+    snapshot_slot_t* slot = &snapshot_sections[section];
+    if (slot->base == 0) {
+        return -1;
+    }
+    
+    slot->config = snapshot_hash(slot->config, config, size);
+    return 0;
+}
+
+int snapshot_restoring(snapshot_section_t section, snapshot_restoring_t restoring) {
+    if ((unsigned int)section >= SNAPSHOT_SECTION_MAX || snapshot_laid_out) {
+        return -1;
+    }
+    snapshot_slot_t* slot = &snapshot_sections[section];
+    if (slot->base == 0) {
+        return -1;
+    }
+    
+    slot->restoring = restoring;
+    return 0;
+}
+
+void snapshot_dirty(snapshot_section_t section, const void* ptr, unsigned int len) {
+    // Before layout everything is dirty anyway
+    if (!snapshot_laid_out || (unsigned int)section >= SNAPSHOT_SECTION_MAX || len == 0) {
+        return;
+    }
+    const snapshot_slot_t* slot = &snapshot_sections[section];
+    unsigned long start = (unsigned long)((const unsigned char*)ptr - slot->base);
+    if (slot->base == 0 || start >= slot->size) {
+        return;
+    }
+    if (len > slot->size - start) {
+        len = (unsigned int)(slot->size - start);
+    }
+    
+    // Single-word ORs: an interrupt marking the same word cannot lose a bit
+    unsigned int first = (slot->offset + (unsigned int)start) / ATA_SECTOR_SIZE;
+    unsigned int last = (slot->offset + (unsigned int)start + len - 1) / ATA_SECTOR_SIZE;
+    for (unsigned int s = first; s <= last; s++) {
+        __asm__ volatile ("lock orl %1, %0" : "+m"(snapshot_dirty_map[s / 32]) : "r"(1U << (s % 32)) : "memory");
+    }
+}
+
+// Mark every data sector dirty
+static void snapshot_dirty_all(void) {
+    for (unsigned int i = 0; i < SNAPSHOT_DIRTY_WORDS; i++) {
+        snapshot_dirty_map[i] = 0xFFFFFFFFU;
+    }
+}
+
+// Assign section offsets in ID order and fingerprint the layout
+// Returns: 0 on success, -1 if the sections do not fit SNAPSHOT_DATA_MAX
+static int snapshot_layout(void) {
+    unsigned int offset = 0;
+    
+    // Handler, entry and load-step pointers are only valid in the build that
+    // stored them. Sizes and addresses alone miss an edit that stays within
+    // a section's page padding, so hash the code itself
+    unsigned int build = snapshot_hash_image(SNAPSHOT_HASH_SEED, __kernel_text_start, __kernel_rodata_end);
+    build = snapshot_hash_image(build, __user_load_start, __user_load_end);
+    
+    for (unsigned int id = 0; id < SNAPSHOT_SECTION_MAX; id++) {
+        snapshot_slot_t* slot = &snapshot_sections[id];
+        if (slot->base == 0) {
+            continue;
+        }
+        if (slot->size > SNAPSHOT_DATA_MAX - offset) {
+            return -1;
+        }
+        slot->offset = offset;
+        offset = (offset + slot->size + SNAPSHOT_ALIGN - 1) & ~(unsigned int)(SNAPSHOT_ALIGN - 1);
+    
+        // Tables hold data pointers too, and were sized and filled under
+        // the tunables of their boot: layout and settings must match as well
+        unsigned long base = (unsigned long)slot->base;
+        build = snapshot_hash(build, &id, sizeof(id));
+        build = snapshot_hash(build, &base, sizeof(base));
+        build = snapshot_hash(build, &slot->size, sizeof(slot->size));
+        build = snapshot_hash(build, &slot->config, sizeof(slot->config));
+    }
+    snapshot_data_size = offset;
+    snapshot_build_id = build;
+    return 0;
+}
+
+int snapshot_init(void) {
+    if (!snapshot_laid_out) {
+        if (snapshot_layout() != 0) {
+            audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Snapshots disabled: tables exceed SNAPSHOT_DATA_MAX");
+            return -1;
+        }
+        snapshot_laid_out = 1;
+        snapshot_dirty_all();
+    }
+    
+    snapshot_disk_ok = 0;
+    unsigned int data_sectors = (snapshot_data_size + ATA_SECTOR_SIZE - 1) / ATA_SECTOR_SIZE;
+    if (ata_init() != 0 || ata_sectors() <= SNAPSHOT_LBA + data_sectors) {
+        audit_emit(AUDIT_TYPE_SYSTEM_INIT, AUDIT_RESULT_NONE, -1, -1, "Snapshots disabled: no ATA disk");
+        return -1;
+    }
+    if (ata_read(SNAPSHOT_LBA, 1, snapshot_disk_header.sector) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Snapshots disabled: disk read failed");
+        return -1;
+    }
+    
+    // Claim only a blank disk or one we wrote before
+    int blank = 1;
+    for (unsigned int i = 0; i < ATA_SECTOR_SIZE; i++) {
+        if (snapshot_disk_header.sector[i] != 0) {
+            blank = 0;
+            break;
+        }
+    }
+    if (!blank && snapshot_disk_header.header.magic != SNAPSHOT_MAGIC) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_DENY, -1, -1, "Snapshots disabled: disk holds other data");
+        return -1;
+    }
+    snapshot_disk_ok = 1;
+    
+    char audit_msg[AUDIT_MSG_MAX];
+    ksnprintf(audit_msg, sizeof(audit_msg), "Snapshot disk ready (%u bytes of tables, v%u)",
+              snapshot_data_size, SNAPSHOT_VERSION);
+    audit_emit(AUDIT_TYPE_SYSTEM_INIT, AUDIT_RESULT_NONE, -1, -1, audit_msg);
+    return 0;
+}
+
+// Check the header sector just read against this kernel's layout
+static int snapshot_header_ok(const snapshot_header_t* header) {
+    if (header->magic != SNAPSHOT_MAGIC || header->version != SNAPSHOT_VERSION ||
+        header->build_id != snapshot_build_id || header->data_size != snapshot_data_size ||
+        header->checksum != snapshot_hash(SNAPSHOT_HASH_SEED, header, (unsigned int)((const unsigned char*)&header->checksum - (const unsigned char*)header))) {
+        return 0;
+    }
+    
+    unsigned int n = 0;
+    for (unsigned int id = 0; id < SNAPSHOT_SECTION_MAX; id++) {
+        const snapshot_slot_t* slot = &snapshot_sections[id];
+        if (slot->base == 0) {
+            continue;
+        }
+        if (n >= header->section_count) {
+            return 0;
+        }
+        const snapshot_entry_t* entry = &header->sections[n++];
+        if (entry->id != id || entry->offset != slot->offset || entry->size != slot->size) {
+            return 0;
+        }
+    }
+    return n == header->section_count;
+}
+
+int snapshot_restore(void) {
+    if (!snapshot_disk_ok) {
+        return -1;
+    }
+    const snapshot_header_t* header = &snapshot_disk_header.header;
+    if (header->magic != SNAPSHOT_MAGIC) {
+        return -1;  // Blank disk: nothing saved yet
+    }
+    
+    char audit_msg[AUDIT_MSG_MAX];
+    unsigned int data_sectors = (snapshot_data_size + ATA_SECTOR_SIZE - 1) / ATA_SECTOR_SIZE;
+    const char* reason = 0;
+    if (!snapshot_header_ok(header)) {
+        reason = "different version, build or tunables";
+    } else if (ata_read(SNAPSHOT_LBA + 1, data_sectors, snapshot_staging) != 0) {
+        reason = "disk read failed";
+    } else {
+        for (unsigned int i = 0; i < header->section_count; i++) {
+            const snapshot_entry_t* entry = &header->sections[i];
+            if (snapshot_hash(SNAPSHOT_HASH_SEED, snapshot_staging + entry->offset, entry->size) != entry->checksum) {
+                reason = "section checksum mismatch";
+                break;
+            }
+        }
+    }
+    if (reason != 0) {
+        ksnprintf(audit_msg, sizeof(audit_msg), "Snapshot generation %u not restored: %s", header->generation, reason);
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, audit_msg);
+        return -1;
+    }
+    
+    // Everything checked: copy the tables back in one pass (after each
+    // owner's restoring hook), then let the owners rebuild what they derive
+    // from them
+    unsigned long flags = interrupts_save();
+    for (unsigned int i = 0; i < header->section_count; i++) {
+        const snapshot_entry_t* entry = &header->sections[i];
+        snapshot_slot_t* slot = &snapshot_sections[entry->id];
+        if (slot->restoring != 0) {
+            slot->restoring();
+        }
+        memcpy(slot->base, snapshot_staging + entry->offset, entry->size);
+        slot->checksum = entry->checksum;
+    }
+    for (unsigned int i = 0; i < SNAPSHOT_DIRTY_WORDS; i++) {
+        snapshot_dirty_map[i] = 0;
+    }
+    interrupts_restore(flags);
+    for (unsigned int i = 0; i < header->section_count; i++) {
+        snapshot_slot_t* slot = &snapshot_sections[header->sections[i].id];
+        if (slot->restored != 0) {
+            slot->restored();
+        }
+    }
+    snapshot_generation_value = header->generation;
+    
+    ksnprintf(audit_msg, sizeof(audit_msg), "Warm boot: restored snapshot generation %u (%u bytes)",
+              snapshot_generation_value, snapshot_data_size);
+    audit_emit(AUDIT_TYPE_SYSTEM_INIT, AUDIT_RESULT_SUCCESS, -1, -1, audit_msg);
+    return 0;
+}
+
+// Does any sector of [offset, offset + size) have its bit set in map
+static int snapshot_range_dirty(const unsigned int* map, unsigned int offset, unsigned int size) {
+    for (unsigned int s = offset / ATA_SECTOR_SIZE; s <= (offset + size - 1) / ATA_SECTOR_SIZE; s++) {
+        if (map[s / 32] & (1U << (s % 32))) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int snapshot_checkpoint(void) {
+    if (!snapshot_disk_ok) {
+        return -1;
+    }
+    
+    // Take the dirty set and gather the dirty sections with interrupts off
+    // (memory only): marks made after this land in the next checkpoint, and
+    // each checksum matches the bytes that will be written
+    unsigned int dirty[SNAPSHOT_DIRTY_WORDS];
+    unsigned long flags = interrupts_save();
+    for (unsigned int i = 0; i < SNAPSHOT_DIRTY_WORDS; i++) {
+        dirty[i] = snapshot_dirty_map[i];
+        snapshot_dirty_map[i] = 0;
+    }
+    for (unsigned int id = 0; id < SNAPSHOT_SECTION_MAX; id++) {
+        snapshot_slot_t* slot = &snapshot_sections[id];
+        if (slot->base != 0 && snapshot_range_dirty(dirty, slot->offset, slot->size)) {
+            memcpy(snapshot_staging + slot->offset, slot->base, slot->size);
+            slot->checksum = snapshot_hash(SNAPSHOT_HASH_SEED, slot->base, slot->size);
+        }
+    }
+    interrupts_restore(flags);
+    
+    // Write runs of dirty sectors (padding between sections is written as staged)
+    int written = 0;
+    unsigned int data_sectors = (snapshot_data_size + ATA_SECTOR_SIZE - 1) / ATA_SECTOR_SIZE;
+    unsigned int s = 0;
+    while (s < data_sectors) {
+        if (!(dirty[s / 32] & (1U << (s % 32)))) {
+            s++;
+            continue;
+        }
+        unsigned int run = s;
+        while (run < data_sectors && (dirty[run / 32] & (1U << (run % 32)))) {
+            run++;
+        }
+        if (ata_write(SNAPSHOT_LBA + 1 + s, run - s, snapshot_staging + s * ATA_SECTOR_SIZE) != 0) {
+            snapshot_dirty_all();
+            return -1;
+        }
+        written += (int)(run - s);
+        s = run;
+    }
+    
+    // Header last: it commits the checkpoint
+    snapshot_header_t* header = &snapshot_disk_header.header;
+    memset(snapshot_disk_header.sector, 0, ATA_SECTOR_SIZE);
+    header->magic = SNAPSHOT_MAGIC;
+    header->version = SNAPSHOT_VERSION;
+    header->build_id = snapshot_build_id;
+    header->generation = snapshot_generation_value + 1;
+    header->data_size = snapshot_data_size;
+    for (unsigned int id = 0; id < SNAPSHOT_SECTION_MAX; id++) {
+        const snapshot_slot_t* slot = &snapshot_sections[id];
+        if (slot->base == 0) {
+            continue;
+        }
+        snapshot_entry_t* entry = &header->sections[header->section_count++];
+        entry->id = id;
+        entry->offset = slot->offset;
+        entry->size = slot->size;
+        entry->checksum = slot->checksum;
+    }
+    header->checksum = snapshot_hash(SNAPSHOT_HASH_SEED, header,
+                                     (unsigned int)((unsigned char*)&header->checksum - (unsigned char*)header));
+    if (ata_write(SNAPSHOT_LBA, 1, snapshot_disk_header.sector) != 0) {
+        snapshot_dirty_all();
+        return -1;
+    }
+    snapshot_generation_value = header->generation;
+    return written + 1;
+}
+
+unsigned int snapshot_generation(void) {
+    return snapshot_generation_value;
+}
+
+// Time one checkpoint; returns cycles and sets *sectors (0 on failure)
+static unsigned long long snapshot_bench_run(int* sectors) {
+    unsigned long long start = clock_cycles();
+    *sectors = snapshot_checkpoint();
+    return clock_cycles() - start;
+}
+
+void snapshot_bench(void) {
+    char line[96];
+    
+    if (!snapshot_disk_ok) {
+        serial_write("BENCH snapshot_checkpoint skipped (no snapshot disk)\n");
+        return;
+    }
+    
+    // Full: every sector; incremental: what one audit record dirties
+    int full_sectors, incremental_sectors;
+    snapshot_dirty_all();
+    unsigned long long full = snapshot_bench_run(&full_sectors);
+    audit_emit(AUDIT_TYPE_SYSTEM_INIT, AUDIT_RESULT_NONE, -1, -1, "Snapshot benchmark marker");
+    unsigned long long incremental = snapshot_bench_run(&incremental_sectors);
+    
+    unsigned int per_us = clock_cycles_per_ms() / 1000;
+    if (per_us == 0) {
+        per_us = 1;
+    }
+    ksnprintf(line, sizeof(line), "BENCH snapshot_checkpoint_full %u us\n", (unsigned int)clock_div64(full, per_us));
+    serial_write(line);
+    ksnprintf(line, sizeof(line), "BENCH snapshot_checkpoint_incremental %u us\n", (unsigned int)clock_div64(incremental, per_us));
+    serial_write(line);
+    ksnprintf(line, sizeof(line), "BENCH-INFO snapshot_checkpoint full=%d incremental=%d sectors\n",
+              full_sectors, incremental_sectors);
+    serial_write(line);
+}
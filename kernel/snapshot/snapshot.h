@@ -0,0 +1,81 @@
+// AgentOS Snapshot Module
+// Week 3: Versioned, incremental checkpoints of kernel tables on disk for warm boots
+
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+// Format version (bump whenever the header or a section layout changes)
+#define SNAPSHOT_VERSION 1
+
+// "AGSN" in the first header word
+#define SNAPSHOT_MAGIC 0x4E534741
+
+// Disk layout: one header sector at SNAPSHOT_LBA, then the sections packed
+// back to back (8-byte aligned) in section ID order, at most SNAPSHOT_DATA_MAX bytes
+#define SNAPSHOT_LBA 0
+#define SNAPSHOT_DATA_MAX (64 * 1024)
+
+// Snapshotted tables, one section each (registered by their modules' init)
+typedef enum {
+    SNAPSHOT_SECTION_AUDIT = 0,  // Audit ring and its seqlock header (audit.c)
+    SNAPSHOT_SECTION_CAPS,       // Capability masks, delegation trees, region rights (cap.c)
+    SNAPSHOT_SECTION_ROUTER,     // Intent handler registrations (router.c)
+    SNAPSHOT_SECTION_AGENTS,     // Agent table (agent.c)
+    SNAPSHOT_SECTION_MAX
+} snapshot_section_t;
+
+// Called after a restore so the owner can rebuild state derived from its table
+typedef void (*snapshot_restored_t)(void);
+
+// Called just before a restore overwrites a table (interrupts disabled), so
+// the owner can keep what this boot already put in it
+typedef void (*snapshot_restoring_t)(void);
+
+// Register a table as a snapshot section (from the owning module's init)
+// Returns: 0 on success, -1 on invalid ID, duplicate, null base or after snapshot_init()
+int snapshot_register(snapshot_section_t section, void* base, unsigned int size, snapshot_restored_t restored);
+
+// Add per-boot settings a section's contents depend on (tunables that size
+// or fill the table) to the snapshot fingerprint, so a boot with other
+// settings boots cold instead of restoring a table built for the old ones
+// Returns: 0 on success, -1 on an unregistered section, null config or after snapshot_init()
+int snapshot_config(snapshot_section_t section, const void* config, unsigned int size);
+
+// Set the hook run before snapshot_restore() overwrites a section
+// Returns: 0 on success, -1 on an unregistered section or after snapshot_init()
+int snapshot_restoring(snapshot_section_t section, snapshot_restoring_t restoring);
+
+// Record that [ptr, ptr + len) of a section changed since the last
+// checkpoint (sector granularity; a few instructions, safe in any context)
+void snapshot_dirty(snapshot_section_t section, const void* ptr, unsigned int len);
+
+// Lay out the registered sections and probe the disk (ata_init()). The disk
+// is only used if its header sector is blank or already holds a snapshot,
+// so a disk with other data on it is never overwritten.
+// Every section starts dirty (the first checkpoint writes everything)
+// Returns: 0 if snapshots can be written, -1 otherwise (audited)
+int snapshot_init(void);
+
+// Warm boot: load the snapshot on disk straight back into the registered
+// tables, replacing their current contents, without replaying creation.
+// The snapshot must have this version, the same kernel build (tables hold
+// code pointers), section layout and settings (snapshot_config()), and every section checksum must
+// match; otherwise nothing is changed. On success the tables are clean.
+// Returns: 0 if restored, -1 otherwise (cold boot)
+int snapshot_restore(void);
+
+// Write a checkpoint: the dirty sectors of every section, then the header
+// (last, with a new generation and section checksums), so a torn
+// checkpoint is rejected by snapshot_restore() instead of half-applied.
+// Cost is proportional to what changed since the previous checkpoint
+// Returns: sectors written (header included), or -1 on failure
+int snapshot_checkpoint(void);
+
+// Generation of the snapshot last written or restored (0 if none)
+unsigned int snapshot_generation(void);
+
+// Microbenchmark: a full checkpoint versus an incremental one after a
+// single audit record; results are written to serial
+void snapshot_bench(void);
+
+#endif // SNAPSHOT_H
@@ -0,0 +1,168 @@
+// AgentOS Intent Statistics Module Implementation
+// Week 3: Always-on intent counters and log2 cycle-latency histograms
+
+#include "stats.h"
+#include "vga.h"            // For VGA_WIDTH
+#include "console/console.h"
+#include "agent/agent.h"    // For AGENT_MAX_COUNT
+#include "intent/intent.h"  // For INTENT_MAX and action names
+#include "lib/format.h"
+
+// Per-(agent, intent action) counters (fixed-size, no heap)
+static stats_intent_t stats_intents[AGENT_MAX_COUNT][INTENT_MAX];
+
+// Per-handler latency histograms, indexed by intent action
+static stats_hist_t stats_handlers[INTENT_MAX];
+
+// Format a percentile bucket bound as "2^k" (or "-" if the histogram is empty)
+static void format_percentile(char* buffer, unsigned int buffer_size, const stats_hist_t* hist, unsigned int percent) {
+    int bucket = stats_hist_percentile(hist, percent);
+    if (bucket < 0) {
+        ksnprintf(buffer, buffer_size, "-");
+        return;
+    }
+    ksnprintf(buffer, buffer_size, "2^%d", bucket + 1);
+}
+
+// Add one sample to a histogram
+static void hist_record(stats_hist_t* hist, unsigned long long cycles) {
+    unsigned int value = cycles > 0xFFFFFFFFULL ? 0xFFFFFFFFU : (unsigned int)cycles;
+    unsigned int bucket = value == 0 ? 0 : 31 - (unsigned int)__builtin_clz(value);
+    hist->buckets[bucket]++;
+    hist->count++;
+}
+
+// Clear a histogram
+static void hist_clear(stats_hist_t* hist) {
+    hist->count = 0;
+    for (unsigned int b = 0; b < STATS_HIST_BUCKETS; b++) {
+        hist->buckets[b] = 0;
+    }
+}
+
+void stats_init(void) {
+    stats_reset();
+}
+
+void stats_record_intent(agent_id_t agent_id, audit_intent_action_t action, stats_outcome_t outcome, unsigned long long cycles) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT || action < 0 || action >= INTENT_MAX) {
+        return;
+    }
+    if (outcome >= STATS_OUTCOME_MAX) {
+        return;
+    }
+    
+    stats_intent_t* entry = &stats_intents[agent_id][action];
+    entry->submitted++;
+    entry->outcomes[outcome]++;
+    hist_record(&entry->latency, cycles);
+}
+
+void stats_record_handler(audit_intent_action_t action, unsigned long long cycles) {
+    if (action < 0 || action >= INTENT_MAX) {
+        return;
+    }
+    hist_record(&stats_handlers[action], cycles);
+}
+
+const stats_intent_t* stats_get_intent(agent_id_t agent_id, audit_intent_action_t action) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT || action < 0 || action >= INTENT_MAX) {
+        return 0;
+    }
+    return &stats_intents[agent_id][action];
+}
+
+const stats_hist_t* stats_get_handler(audit_intent_action_t action) {
+    if (action < 0 || action >= INTENT_MAX) {
+        return 0;
+    }
+    return &stats_handlers[action];
+}
+
+int stats_hist_percentile(const stats_hist_t* hist, unsigned int percent) {
+    if (hist == 0 || hist->count == 0) {
+        return -1;
+    }
+    if (percent > 100) {
+        percent = 100;
+    }
+    
+    // Rank of the requested percentile (1-based, rounded up), in 32-bit arithmetic
+    unsigned int rank = (hist->count / 100) * percent + ((hist->count % 100) * percent + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    
+    unsigned int seen = 0;
+    for (unsigned int b = 0; b < STATS_HIST_BUCKETS; b++) {
+        seen += hist->buckets[b];
+        if (seen >= rank) {
+            return (int)b;
+        }
+    }
+    return STATS_HIST_BUCKETS - 1;
+}
+
+void stats_reset(void) {
+    for (unsigned int i = 0; i < AGENT_MAX_COUNT; i++) {
+        for (unsigned int a = 0; a < INTENT_MAX; a++) {
+            stats_intent_t* entry = &stats_intents[i][a];
+            entry->submitted = 0;
+            for (unsigned int o = 0; o < STATS_OUTCOME_MAX; o++) {
+                entry->outcomes[o] = 0;
+            }
+            hist_clear(&entry->latency);
+        }
+    }
+    for (unsigned int a = 0; a < INTENT_MAX; a++) {
+        hist_clear(&stats_handlers[a]);
+    }
+}
+
+void stats_dump_to_console(void) {
+    char line[VGA_WIDTH];  // At most VGA_WIDTH - 1 characters, so lines never auto-wrap
+    char p50[8];
+    char p99[8];
+    
+    console_batch_begin();
+    console_write(CONSOLE_KERNEL, "Intent stats (latency in cycles):\n");
+    
+    // One line per active (agent, action) pair:
+    // "a0 CONSOLE_WRITE n=1 ok=1 deny=0 thr=0 fail=0 p50<2^k p99<2^k"
+    for (unsigned int i = 0; i < AGENT_MAX_COUNT; i++) {
+        for (unsigned int a = 0; a < INTENT_MAX; a++) {
+            const stats_intent_t* entry = &stats_intents[i][a];
+            if (entry->submitted == 0) {
+                continue;
+            }
+            format_percentile(p50, sizeof(p50), &entry->latency, 50);
+            format_percentile(p99, sizeof(p99), &entry->latency, 99);
+            ksnprintf(line, VGA_WIDTH, " a%u %s n=%u ok=%u deny=%u thr=%u fail=%u p50<%s p99<%s",
+                      i, intent_action_to_string((intent_action_t)a),
+                      entry->submitted,
+                      entry->outcomes[STATS_OUTCOME_ALLOW],
+                      entry->outcomes[STATS_OUTCOME_DENY],
+                      entry->outcomes[STATS_OUTCOME_THROTTLE],
+                      entry->outcomes[STATS_OUTCOME_FAILURE],
+                      p50, p99);
+            console_write(CONSOLE_KERNEL, line);
+            console_write(CONSOLE_KERNEL, "\n");
+        }
+    }
+    
+    // One line per handler with samples: "h CONSOLE_WRITE n=1 p50<2^k p99<2^k"
+    for (unsigned int a = 0; a < INTENT_MAX; a++) {
+        const stats_hist_t* hist = &stats_handlers[a];
+        if (hist->count == 0) {
+            continue;
+        }
+        format_percentile(p50, sizeof(p50), hist, 50);
+        format_percentile(p99, sizeof(p99), hist, 99);
+        ksnprintf(line, VGA_WIDTH, " h %s n=%u p50<%s p99<%s",
+                  intent_action_to_string((intent_action_t)a), hist->count, p50, p99);
+        console_write(CONSOLE_KERNEL, line);
+        console_write(CONSOLE_KERNEL, "\n");
+    }
+    
+    console_batch_end();
+}
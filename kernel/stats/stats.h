@@ -0,0 +1,62 @@
+// AgentOS Intent Statistics Module
+// Week 3: Always-on intent counters and log2 cycle-latency histograms
+
+#ifndef STATS_H
+#define STATS_H
+
+#include "audit/audit.h"  // For agent_id_t and audit_intent_action_t
+
+// Number of log2 histogram buckets (bucket k counts values in [2^k, 2^(k+1)))
+#define STATS_HIST_BUCKETS 32
+
+// Outcome of one intent submission
+typedef enum {
+    STATS_OUTCOME_ALLOW = 0,     // Handler executed successfully
+    STATS_OUTCOME_DENY,          // Capability check failed
+    STATS_OUTCOME_THROTTLE,      // Rejected by rate quota
+    STATS_OUTCOME_FAILURE,       // No handler or handler error
+    STATS_OUTCOME_MAX            // Sentinel value
+} stats_outcome_t;
+
+// Log2-bucketed histogram of cycle counts
+typedef struct {
+    unsigned int count;                        // Number of samples
+    unsigned int buckets[STATS_HIST_BUCKETS];  // Samples per log2 bucket
+} stats_hist_t;
+
+// Counters for one (agent, intent action) pair
+typedef struct {
+    unsigned int submitted;                    // Valid submissions
+    unsigned int outcomes[STATS_OUTCOME_MAX];  // Submissions per outcome
+    stats_hist_t latency;                      // sys_intent_submit() cycles
+} stats_intent_t;
+
+// Initialize the statistics tables (all counters zero)
+void stats_init(void);
+
+// Record one intent submission and its end-to-end cycle count
+// Called from sys_intent_submit() on every exit path after validation
+void stats_record_intent(agent_id_t agent_id, audit_intent_action_t action, stats_outcome_t outcome, unsigned long long cycles);
+
+// Record one handler invocation (called by the intent router)
+void stats_record_handler(audit_intent_action_t action, unsigned long long cycles);
+
+// Read counters for an (agent, intent action) pair
+// Returns: pointer to live counters, or 0 (NULL) for invalid arguments
+const stats_intent_t* stats_get_intent(agent_id_t agent_id, audit_intent_action_t action);
+
+// Read the handler latency histogram for an intent action
+// Returns: pointer to live histogram, or 0 (NULL) for invalid action
+const stats_hist_t* stats_get_handler(audit_intent_action_t action);
+
+// Get the bucket index containing the given percentile (0-100) of a histogram
+// Returns: bucket index k (values below 2^(k+1)), or -1 if the histogram is empty
+int stats_hist_percentile(const stats_hist_t* hist, unsigned int percent);
+
+// Reset all counters and histograms to zero
+void stats_reset(void);
+
+// Dump non-zero counters and handler histograms to the kernel console
+void stats_dump_to_console(void);
+
+#endif // STATS_H
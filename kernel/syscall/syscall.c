@@ -3,10 +3,28 @@
 
 #include "syscall.h"
 #include "cap/cap.h"
-#include "vga.h"
+#include "console/console.h"
 #include "audit/audit.h"
 #include "intent/intent.h"
 #include "intent/router.h"
+#include "quota/quota.h"
+#include "clock/clock.h"
+#include "stats/stats.h"
+#include "trace/trace.h"
+#include "timer/sleep.h"
+#include "agent/agent.h"
+#include "serial.h"
+#include "tunable/tunable.h"
+#include "user/user.h"
+#include "lib/string.h"
+#include "lib/format.h"
+#include "arch/x86_64/idt.h"
+#include "arch/x86_64/paging.h"
+#include "arch/x86_64/usermode.h"
+
+// Longest intent payload accepted from ring 3, terminator included
+// (payload_max= tunable, at most INTENT_PAYLOAD_MAX)
+static unsigned long syscall_payload_max = INTENT_PAYLOAD_MAX;
 
 int sys_console_write(agent_id_t agent_id, const char* msg) {
     // Validate arguments
@@ -29,7 +47,7 @@ int sys_console_write(agent_id_t agent_id, const char* msg) {
     }
     
     // Capability allowed - write to console
-    vga_write(msg);
+    console_write(agent_id, msg);
     
     // Emit audit ALLOW event with structured record
     // Structured fields: type=USER_ACTION, result=ALLOW, agent_id, intent_action=-1 (not intent-based)
@@ -54,6 +72,19 @@ int sys_intent_submit(agent_id_t agent_id, const intent_t* intent) {
         return -1;
     }
     
+    // Start of the submit-to-complete interval recorded in the stats module
+    unsigned long long start = clock_cycles();
+    TRACE_BEGIN(TRACE_INTENT_SUBMIT, (int)intent->action);
+    
+    // Admission control: charge the (agent, action) token bucket before any
+    // per-intent audit record, so a flooding agent is summarized by quota_admit()
+    // instead of evicting everyone else's events from the audit ring
+    if (!quota_admit(agent_id, (int)intent->action)) {
+        stats_record_intent(agent_id, (int)intent->action, STATS_OUTCOME_THROTTLE, clock_cycles() - start);
+        TRACE_END(TRACE_INTENT_SUBMIT, (int)intent->action);
+        return SYS_ERR_THROTTLED;
+    }
+    
     // Audit INTENT_SUBMIT event with structured record
     // Structured fields: type=INTENT_SUBMIT, result=NONE, agent_id, intent_action
     // Message provides payload context (already captured in structured fields above)
@@ -66,6 +97,8 @@ int sys_intent_submit(agent_id_t agent_id, const intent_t* intent) {
         // No handler registered for this action - emit audit error with structured record
         // Structured fields: type=SYSTEM_ERROR, result=FAILURE, agent_id, intent_action
         audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, agent_id, (int)intent->action, "No handler registered for intent action");
+        stats_record_intent(agent_id, (int)intent->action, STATS_OUTCOME_FAILURE, clock_cycles() - start);
+        TRACE_END(TRACE_INTENT_SUBMIT, (int)intent->action);
         return -1;
     }
     
@@ -78,18 +111,41 @@ int sys_intent_submit(agent_id_t agent_id, const intent_t* intent) {
         // Structured fields: type=SYSTEM_ERROR, result=DENY, agent_id, intent_action
         // Message provides payload context (capability denial details already in structured fields)
         audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_DENY, agent_id, (int)intent->action, intent->payload);
+        stats_record_intent(agent_id, (int)intent->action, STATS_OUTCOME_DENY, clock_cycles() - start);
+        TRACE_END(TRACE_INTENT_SUBMIT, (int)intent->action);
         
         return -1;
     }
     
-    // Capability allowed - call handler
-    int handler_result = handler(agent_id, intent);
+    // Capability allowed - call handler through the router (times it per handler),
+    // under the intent's deadline (only handlers that wait can miss it)
+    sleep_deadline_begin(SLEEP_INTENT_TIMEOUT_MS);
+    int handler_result = intent_dispatch(agent_id, intent);
+    sleep_deadline_end();
+    
+    if (handler_result == INTENT_ERR_TIMEOUT) {
+        // Deadline passed while the handler waited; the intent was abandoned
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, agent_id, (int)intent->action, "Intent timed out");
+        stats_record_intent(agent_id, (int)intent->action, STATS_OUTCOME_FAILURE, clock_cycles() - start);
+        TRACE_END(TRACE_INTENT_SUBMIT, (int)intent->action);
+        return SYS_ERR_TIMEOUT;
+    }
     
-    if (handler_result != 0) {
+    if (handler_result == INTENT_ERR_BACKPRESSURE) {
+        // Sink full - not a failure of the intent itself; the agent should retry
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_THROTTLE, agent_id, (int)intent->action, "Output queue full");
+        stats_record_intent(agent_id, (int)intent->action, STATS_OUTCOME_THROTTLE, clock_cycles() - start);
+        TRACE_END(TRACE_INTENT_SUBMIT, (int)intent->action);
+        return SYS_ERR_BACKPRESSURE;
+    }
+    
+    if (handler_result < 0) {
         // Handler execution failed - emit audit failure event with structured record
         // Structured fields: type=SYSTEM_ERROR, result=FAILURE, agent_id, intent_action
         // Message provides payload context (handler failure details)
         audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, agent_id, (int)intent->action, intent->payload);
+        stats_record_intent(agent_id, (int)intent->action, STATS_OUTCOME_FAILURE, clock_cycles() - start);
+        TRACE_END(TRACE_INTENT_SUBMIT, (int)intent->action);
         return -1;
     }
     
@@ -97,6 +153,98 @@ int sys_intent_submit(agent_id_t agent_id, const intent_t* intent) {
     // Structured fields: type=USER_ACTION, result=ALLOW, agent_id, intent_action
     // Message provides payload context (intent execution details)
     audit_emit(AUDIT_TYPE_USER_ACTION, AUDIT_RESULT_ALLOW, agent_id, (int)intent->action, intent->payload);
+    stats_record_intent(agent_id, (int)intent->action, STATS_OUTCOME_ALLOW, clock_cycles() - start);
+    TRACE_END(TRACE_INTENT_SUBMIT, (int)intent->action);
     
-    return 0;
+    // Handlers may hand back a non-negative result (e.g. a new region ID)
+    return handler_result;
+}
+
+// Build a kernel copy of an intent described in registers
+static long sys_intent_submit_user(agent_id_t agent_id, unsigned long action, unsigned long payload, unsigned long len) {
+    if (action >= INTENT_MAX || len >= syscall_payload_max) {
+        return -1;
+    }
+    
+    // The payload must be agent memory; a kernel address would let the agent
+    // read kernel data back through the intent
+    if (!paging_user_range_ok(payload, len)) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_DENY, agent_id, (int)action, "Intent payload outside agent memory");
+        return -1;
+    }
+    
+    intent_t intent;
+    intent.action = (intent_action_t)action;
+    memcpy(intent.payload, (const void*)payload, len);
+    intent.payload[len] = '\0';
+    return sys_intent_submit(agent_id, &intent);
+}
+
+long sys_dispatch(unsigned long nr, unsigned long a1, unsigned long a2, unsigned long a3) {
+    if (nr == SYS_NR_NOP) {
+        return 0;
+    }
+    if (nr == SYS_NR_EXIT) {
+        usermode_exit((long)a1);
+    }
+    long result = -1;
+    if (nr == SYS_NR_INTENT_SUBMIT) {
+        result = sys_intent_submit_user(agent_current(), a1, a2, a3);
+    }
+    
+    // An agent that used up its CPU budget during the call does not get back
+    agent_budget_check();
+    return result;
+}
+
+// int 0x80 gate: same numbers and arguments, passed in the saved frame
+static void syscall_int80(interrupt_frame_t* frame) {
+    INTERRUPT_FRAME_RET(frame) = (unsigned long)sys_dispatch(INTERRUPT_FRAME_SYSCALL_NR(frame),
+                                                             INTERRUPT_FRAME_ARG1(frame),
+                                                             INTERRUPT_FRAME_ARG2(frame),
+                                                             INTERRUPT_FRAME_ARG3(frame));
+}
+
+void syscall_init(void) {
+    syscall_payload_max = tunable_get(TUNABLE_PAYLOAD_MAX);
+    if (interrupt_register(IDT_VECTOR_SYSCALL, syscall_int80) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register int 0x80 gate");
+    }
+}
+
+void syscall_bench(void) {
+    char line[96];
+    
+    int id = agent_create("bench", user_bench_entry, 0);
+    if (id < 0 || agent_run(id) != 0) {
+        serial_write("BENCH syscall skipped (bench agent failed)\n");
+        return;
+    }
+    
+    // The agent left its results at the start of its window
+    const user_bench_result_t* result = (const user_bench_result_t*)paging_window(id);
+    if (result->rounds == 0) {
+        serial_write("BENCH syscall skipped (no results)\n");
+        return;
+    }
+    
+    // Lines: "BENCH <metric> <value> <unit>"
+    ksnprintf(line, sizeof(line), "BENCH syscall_fast_roundtrip %u cycles\n",
+              (unsigned int)clock_div64(result->fast_cycles, result->rounds));
+    serial_write(line);
+    ksnprintf(line, sizeof(line), "BENCH syscall_int80_roundtrip %u cycles\n",
+              (unsigned int)clock_div64(result->int80_cycles, result->rounds));
+    serial_write(line);
+    
+    // Intent scenarios, per intent (the agent may have run out of budget first)
+    if (result->intents == 0) {
+        serial_write("BENCH intent skipped (no results)\n");
+        return;
+    }
+    ksnprintf(line, sizeof(line), "BENCH intent_flood %u cycles\n",
+              (unsigned int)clock_div64(result->flood_cycles, result->intents));
+    serial_write(line);
+    ksnprintf(line, sizeof(line), "BENCH intent_deny_storm %u cycles\n",
+              (unsigned int)clock_div64(result->deny_cycles, result->intents));
+    serial_write(line);
 }
@@ -7,14 +7,53 @@
 #include "audit/audit.h"  // For agent_id_t
 #include "intent/intent.h"  // For intent_t
 
+// Error returned by sys_intent_submit() when the intent was rejected by the
+// agent's rate quota (the agent should back off and retry later)
+#define SYS_ERR_THROTTLED -2
+
+// Error returned by sys_intent_submit() when the handler's output sink is
+// full (e.g. the agent's console queue); the intent was not executed
+#define SYS_ERR_BACKPRESSURE -3
+
+// Error returned by sys_intent_submit() when the intent did not complete
+// within SLEEP_INTENT_TIMEOUT_MS (e.g. a sleep longer than the deadline)
+#define SYS_ERR_TIMEOUT -4
+
+// System call numbers for the register ABI shared by the sysenter/syscall
+// fast path and the int 0x80 gate (user stubs in kernel/user/user.h)
+//   i386:   eax = number, ebx/esi/edi = arguments, result in eax
+//   x86_64: rax = number, rdi/rsi/rdx = arguments, result in rax
+// The calling agent is always the one running; it is never passed in
+#define SYS_NR_NOP 0            // Empty round trip (benchmarks)
+#define SYS_NR_EXIT 1           // a1 = exit code; does not return
+#define SYS_NR_INTENT_SUBMIT 2  // a1 = action, a2 = payload address, a3 = payload length
+
 // System call: Write to console
 // Enforces CAP_CONSOLE_WRITE capability
 // Returns: 0 on success, -1 on failure (capability denied or invalid args)
 int sys_console_write(agent_id_t agent_id, const char* msg);
 
 // System call: Submit an intent for execution
-// Validates intent action, checks required capabilities, and executes intent
-// Returns: 0 on success, -1 on failure (invalid args, capability denied, or execution error)
+// Validates intent action, applies the agent's rate quota, checks required capabilities, and executes intent
+// Returns: 0 or the handler's non-negative result on success, SYS_ERR_THROTTLED if rate limited,
+//          SYS_ERR_BACKPRESSURE if the handler's sink is full, SYS_ERR_TIMEOUT if it missed its deadline,
+//          -1 on failure (invalid args, capability denied, or execution error)
 int sys_intent_submit(agent_id_t agent_id, const intent_t* intent);
 
+// Register the int 0x80 gate handler (the fast path is set up by usermode_init)
+void syscall_init(void);
+
+// Dispatch a system call from ring 3 (called by both entry paths)
+// SYS_NR_INTENT_SUBMIT copies the payload into a kernel intent_t after checking
+// that it lies in the agent's user memory, then calls sys_intent_submit()
+// An agent that went over its CPU budget during the call is stopped instead
+// of returning (agent_budget_check())
+// Returns: the call's result, -1 for an unknown number or invalid arguments
+long sys_dispatch(unsigned long nr, unsigned long a1, unsigned long a2, unsigned long a3);
+
+// Microbenchmark: round-trip cost of the fast path versus int 0x80, and the
+// per-intent cost of an intent flood and a deny storm, measured by a ring-3
+// agent; results are written to serial
+void syscall_bench(void);
+
 #endif // SYSCALL_H
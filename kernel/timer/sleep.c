@@ -0,0 +1,152 @@
+// AgentOS Sleep Module Implementation
+// Week 3: Agent sleeps, per-agent alarms and intent deadlines on the timing wheel
+
+#include "sleep.h"
+#include "wheel.h"
+#include "timer.h"
+#include "agent/agent.h"          // For AGENT_MAX_COUNT
+#include "arch/x86_64/idt.h"      // For interrupts_save/restore
+
+// One alarm per agent (fixed-size, no heap)
+typedef struct {
+    wheel_timer_t timer;
+    volatile unsigned int expirations;   // Fired since the last wait
+} sleep_alarm_t;
+
+static sleep_alarm_t sleep_alarms[AGENT_MAX_COUNT];
+
+// Deadline of the intent being executed; agents run one at a time, so one
+// is enough
+static wheel_timer_t sleep_deadline;
+static volatile int sleep_deadline_hit = 0;
+
+// Wheel callbacks (run with interrupts disabled)
+static void sleep_set_flag(void* arg) {
+    *(volatile int*)arg = 1;
+}
+
+static void sleep_alarm_fired(void* arg) {
+    ((sleep_alarm_t*)arg)->expirations++;
+}
+
+// Idle until ready() returns non-zero, *done is set or the intent deadline
+// passes; the wheel is run before every check, so an expiry is never slept
+// through
+// Returns: 1 if ready, 0 if done, SLEEP_ERR_DEADLINE on deadline
+static int sleep_wait(int (*ready)(void), volatile int* done) {
+    unsigned long flags = interrupts_save();
+    int result;
+    for (;;) {
+        unsigned int due = wheel_next_due();
+        if (ready != 0 && ready()) {
+            result = 1;
+            break;
+        }
+        if (*done) {
+            result = 0;
+            break;
+        }
+        if (sleep_deadline_hit) {
+            result = SLEEP_ERR_DEADLINE;
+            break;
+        }
+        timer_idle(due);
+    }
+    interrupts_restore(flags);
+    return result;
+}
+
+void sleep_init(void) {
+    for (unsigned int i = 0; i < AGENT_MAX_COUNT; i++) {
+        wheel_timer_cancel(&sleep_alarms[i].timer);
+        sleep_alarms[i].expirations = 0;
+    }
+    wheel_timer_cancel(&sleep_deadline);
+    sleep_deadline_hit = 0;
+}
+
+int sleep_until(int (*ready)(void), unsigned int ms) {
+    wheel_timer_t timer = {0};
+    volatile int done = 0;
+    if (ms != 0 && wheel_timer_arm(&timer, wheel_ms_to_ticks(ms), 0, sleep_set_flag, (void*)&done) != 0) {
+        return -1;
+    }
+    
+    int result = sleep_wait(ready, &done);
+    
+    // The timer lives on this stack frame; never leave it linked
+    wheel_timer_cancel(&timer);
+    return result;
+}
+
+int sleep_ms(unsigned int ms) {
+    // sleep_until() treats 0 as no time limit
+    if (ms == 0) {
+        return 0;
+    }
+    return sleep_until(0, ms);
+}
+
+int sleep_alarm_arm(int agent_id, unsigned int ms, int periodic) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT || ms > SLEEP_MS_MAX) {
+        return -1;
+    }
+    
+    sleep_alarm_t* alarm = &sleep_alarms[agent_id];
+    wheel_timer_cancel(&alarm->timer);
+    alarm->expirations = 0;
+    if (ms == 0) {
+        return 0;
+    }
+    
+    unsigned int ticks = wheel_ms_to_ticks(ms);
+    return wheel_timer_arm(&alarm->timer, ticks, periodic ? ticks : 0, sleep_alarm_fired, alarm);
+}
+
+int sleep_alarm_wait(int agent_id) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT) {
+        return -1;
+    }
+    
+    sleep_alarm_t* alarm = &sleep_alarms[agent_id];
+    unsigned long flags = interrupts_save();
+    int result;
+    for (;;) {
+        unsigned int due = wheel_next_due();
+        if (alarm->expirations != 0) {
+            result = (int)alarm->expirations;
+            alarm->expirations = 0;
+            break;
+        }
+        // Nothing armed would make this wait forever
+        if (!alarm->timer.armed) {
+            result = -1;
+            break;
+        }
+        if (sleep_deadline_hit) {
+            result = SLEEP_ERR_DEADLINE;
+            break;
+        }
+        timer_idle(due);
+    }
+    interrupts_restore(flags);
+    return result;
+}
+
+void sleep_agent_exit(int agent_id) {
+    if (agent_id < 0 || agent_id >= AGENT_MAX_COUNT) {
+        return;
+    }
+    wheel_timer_cancel(&sleep_alarms[agent_id].timer);
+    sleep_alarms[agent_id].expirations = 0;
+}
+
+void sleep_deadline_begin(unsigned int ms) {
+    sleep_deadline_hit = 0;
+    wheel_timer_arm(&sleep_deadline, wheel_ms_to_ticks(ms), 0, sleep_set_flag, (void*)&sleep_deadline_hit);
+}
+
+void sleep_deadline_end(void) {
+    wheel_timer_cancel(&sleep_deadline);
+    sleep_deadline_hit = 0;
+}
@@ -0,0 +1,55 @@
+// AgentOS Sleep Module
+// Week 3: Agent sleeps, per-agent alarms and intent deadlines on the timing wheel
+
+#ifndef SLEEP_H
+#define SLEEP_H
+
+// Longest sleep or alarm interval accepted from an intent (ms)
+#define SLEEP_MS_MAX 3600000
+
+// Deadline for one intent, from submit to completion (ms); a handler still
+// waiting when it passes is aborted with INTENT_ERR_TIMEOUT
+#define SLEEP_INTENT_TIMEOUT_MS 10000
+
+// Wait result: the intent deadline passed before the wait was over
+#define SLEEP_ERR_DEADLINE -2
+
+// Initialize the alarm table (no alarms armed)
+// Requires wheel_init()
+void sleep_init(void);
+
+// Halt for ms milliseconds (tickless: the CPU idles until the wheel's next
+// expiry); must not be called from a wheel callback
+// Returns: 0 when the time has passed, SLEEP_ERR_DEADLINE if the intent
+// deadline passed first, -1 if the wheel is not initialized
+int sleep_ms(unsigned int ms);
+
+// Halt until ready() returns non-zero (checked after every interrupt, so
+// an IRQ that produces the event completes the wait), or until ms
+// milliseconds have passed if ms is non-zero; ready() runs with interrupts
+// disabled
+// Returns: 1 when ready, 0 if ms passed first, SLEEP_ERR_DEADLINE if the
+// intent deadline passed first, -1 if the wheel is not initialized
+int sleep_until(int (*ready)(void), unsigned int ms);
+
+// Arm agent_id's alarm to fire after ms milliseconds, and every ms after
+// that if periodic is set; ms 0 cancels it. Re-arming discards expirations
+// that were not waited for
+// Returns: 0 on success, -1 on invalid agent or interval
+int sleep_alarm_arm(int agent_id, unsigned int ms, int periodic);
+
+// Wait until agent_id's alarm has fired at least once since the last wait
+// Returns: expirations since the last wait (>= 1, more if a periodic alarm
+// fired again before the agent came back), -1 if no alarm is armed,
+// SLEEP_ERR_DEADLINE if the intent deadline passed first
+int sleep_alarm_wait(int agent_id);
+
+// Cancel agent_id's alarm when its run ends (called by agent_run())
+void sleep_agent_exit(int agent_id);
+
+// Start and stop the deadline of the intent being executed (called by
+// sys_intent_submit() around the handler)
+void sleep_deadline_begin(unsigned int ms);
+void sleep_deadline_end(void);
+
+#endif // SLEEP_H
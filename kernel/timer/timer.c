@@ -0,0 +1,155 @@
+// AgentOS Timer Module Implementation
+// Week 3: Periodic PIT channel 0 tick with registered tick handlers
+
+#include "timer.h"
+#include "arch/x86_64/io.h"
+#include "arch/x86_64/pic.h"
+#include "audit/audit.h"
+#include "clock/clock.h"  // For idle time accounting
+
+// PIT input frequency (Hz)
+#define PIT_FREQUENCY_HZ 1193182
+
+// PIT I/O ports
+#define PIT_CHANNEL0_PORT 0x40
+#define PIT_COMMAND_PORT  0x43
+
+// PIT IRQ line
+#define TIMER_IRQ 0
+
+// Tick counter (written only by the IRQ handler)
+static volatile unsigned int timer_tick_count = 0;
+
+// Configured rate and the PIT count that produces it
+static unsigned int timer_hz_value = 0;
+static unsigned int timer_divisor = 0;
+
+// Ticks covered by the pending one-shot count (0 while periodic)
+static volatile unsigned int timer_oneshot_ticks = 0;
+
+// Cycles spent halted in timer_idle()
+static unsigned long long timer_idle_total = 0;
+
+// Registered tick handlers (fixed-size, no heap)
+static timer_tick_handler_t timer_tick_handlers[TIMER_TICK_HANDLER_MAX];
+static unsigned int timer_tick_handler_count = 0;
+
+// Program channel 0: mode 2 (rate generator) or mode 0 (one interrupt at terminal count)
+static void timer_program(unsigned char mode, unsigned int count) {
+    outb(PIT_COMMAND_PORT, (unsigned char)(0x30 | (mode << 1)));
+    outb(PIT_CHANNEL0_PORT, (unsigned char)(count & 0xFF));
+    outb(PIT_CHANNEL0_PORT, (unsigned char)((count >> 8) & 0xFF));
+}
+
+// IRQ0 handler
+static void timer_irq(interrupt_frame_t* frame) {
+    // A one-shot interrupt ends an idle stretch of several ticks
+    if (timer_oneshot_ticks != 0) {
+        timer_tick_count += timer_oneshot_ticks;
+        timer_oneshot_ticks = 0;
+    } else {
+        timer_tick_count++;
+    }
+    for (unsigned int i = 0; i < timer_tick_handler_count; i++) {
+        timer_tick_handlers[i](frame);
+    }
+}
+
+void timer_init(unsigned int hz) {
+    if (hz == 0) {
+        hz = TIMER_HZ;
+    }
+    
+    unsigned int divisor = PIT_FREQUENCY_HZ / hz;
+    if (divisor == 0) {
+        divisor = 1;
+    } else if (divisor > 0xFFFF) {
+        divisor = 0xFFFF;
+    }
+    timer_hz_value = PIT_FREQUENCY_HZ / divisor;
+    timer_divisor = divisor;
+    
+    // Channel 0, lobyte/hibyte access, mode 2 (rate generator)
+    timer_program(2, divisor);
+    
+    if (interrupt_register(PIC_IRQ_BASE + TIMER_IRQ, timer_irq) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register timer IRQ");
+        return;
+    }
+    pic_unmask(TIMER_IRQ);
+    
+    audit_emit(AUDIT_TYPE_SYSTEM_INIT, AUDIT_RESULT_NONE, -1, -1, "Timer initialized");
+}
+
+int timer_register_tick(timer_tick_handler_t handler) {
+    if (handler == 0 || timer_tick_handler_count >= TIMER_TICK_HANDLER_MAX) {
+        return -1;
+    }
+    // Publish the slot before the count so the IRQ never sees an empty entry
+    timer_tick_handlers[timer_tick_handler_count] = handler;
+    __asm__ volatile ("" : : : "memory");
+    timer_tick_handler_count++;
+    return 0;
+}
+
+unsigned int timer_ticks(void) {
+    return timer_tick_count;
+}
+
+unsigned int timer_hz(void) {
+    return timer_hz_value;
+}
+
+void timer_idle(unsigned int ticks) {
+    // Short waits (and a timer that was never started) keep the periodic tick
+    if (ticks <= 1 || timer_divisor == 0) {
+        unsigned long long halt_start = clock_cycles();
+        __asm__ volatile ("sti; hlt; cli" : : : "memory");
+        timer_idle_total += clock_cycles() - halt_start;
+        return;
+    }
+    
+    if (ticks == TIMER_IDLE_FOREVER) {
+        pic_mask(TIMER_IRQ);
+    } else {
+        // Mode 0 counts down once; 0xFFFF is the longest count
+        unsigned int max_ticks = 0xFFFF / timer_divisor;
+        if (ticks > max_ticks) {
+            ticks = max_ticks;
+        }
+        timer_oneshot_ticks = ticks;
+        timer_program(0, ticks * timer_divisor);
+    }
+    
+    // sti takes effect after hlt, so no interrupt slips in before the halt
+    unsigned long long start = clock_cycles();
+    __asm__ volatile ("sti; hlt; cli" : : : "memory");
+    unsigned long long halted = clock_cycles() - start;
+    timer_idle_total += halted;
+    
+    // Woken by another interrupt first: count the ticks slept so far
+    if (ticks == TIMER_IDLE_FOREVER || timer_oneshot_ticks != 0) {
+        unsigned int per_ms = clock_cycles_per_ms();
+        unsigned int slept = 0;
+        if (per_ms != 0) {
+            unsigned int ms = (unsigned int)clock_div64(halted, per_ms);
+            slept = (ms / 1000) * timer_hz_value + (ms % 1000) * timer_hz_value / 1000;
+        }
+        if (ticks != TIMER_IDLE_FOREVER && slept >= ticks) {
+            slept = ticks - 1;
+        }
+        timer_tick_count += slept;
+        timer_oneshot_ticks = 0;
+    }
+    
+    // Back to the periodic tick
+    timer_program(2, timer_divisor);
+    if (ticks == TIMER_IDLE_FOREVER) {
+        pic_unmask(TIMER_IRQ);
+    }
+}
+
+unsigned long long timer_idle_cycles(void) {
+    // Only timer_idle() writes it, never from an interrupt, so no tearing
+    return timer_idle_total;
+}
@@ -0,0 +1,48 @@
+// AgentOS Timer Module
+// Week 3: Periodic PIT channel 0 tick with registered tick handlers
+
+#ifndef TIMER_H
+#define TIMER_H
+
+#include "arch/x86_64/idt.h"  // For interrupt_frame_t
+
+// Default tick rate (Hz)
+#define TIMER_HZ 1000
+
+// Maximum number of tick handlers (profiler, console drain, timing wheel
+// and budget tick use four; the rest is headroom, since a hook that fails
+// to register is only audited)
+#define TIMER_TICK_HANDLER_MAX 8
+
+// Tick handler type: receives the interrupted register state
+typedef void (*timer_tick_handler_t)(interrupt_frame_t* frame);
+
+// Program PIT channel 0 as a periodic rate generator and unmask IRQ0
+// Interrupts must be enabled separately (interrupts_enable())
+void timer_init(unsigned int hz);
+
+// Register a function called on every tick, in registration order
+// Returns: 0 on success, -1 on failure (table full or invalid handler)
+int timer_register_tick(timer_tick_handler_t handler);
+
+// Get the number of ticks since timer_init()
+unsigned int timer_ticks(void);
+
+// Get the configured tick rate (Hz)
+unsigned int timer_hz(void);
+
+// timer_idle() argument: no wakeup needed from the timer
+#define TIMER_IDLE_FOREVER 0xFFFFFFFFU
+
+// Halt for up to ticks ticks, or until another interrupt arrives
+// For more than one tick the periodic tick is stopped: the PIT is set to
+// fire once at the deadline (capped at its longest count), or IRQ0 is
+// masked for TIMER_IDLE_FOREVER. The ticks slept through are added to the
+// tick count on wakeup, but tick handlers do not run for them.
+// Must be called with interrupts disabled; returns with them disabled
+void timer_idle(unsigned int ticks);
+
+// Total TSC cycles spent halted in timer_idle() (CPU time charged to no one)
+unsigned long long timer_idle_cycles(void);
+
+#endif // TIMER_H
@@ -0,0 +1,225 @@
+// AgentOS Timing Wheel Module Implementation
+// Week 3: Hierarchical timing wheel driven by the timer tick, with tickless idle
+
+#include "wheel.h"
+#include "timer.h"
+#include "audit/audit.h"
+#include "arch/x86_64/idt.h"  // For interrupts_save/restore
+
+#define WHEEL_MASK (WHEEL_SLOTS - 1)
+
+// Slot list sentinels, one list per (level, slot)
+static wheel_link_t wheel_slots[WHEEL_LEVELS][WHEEL_SLOTS];
+
+// Next tick to process; every armed timer expires at or after it
+static unsigned int wheel_tick = 0;
+
+// Number of armed timers (lets idle periods be skipped without walking them)
+static unsigned int wheel_armed = 0;
+
+static int wheel_initialized = 0;
+
+static inline int wheel_list_empty(const wheel_link_t* head) {
+    return head->next == head;
+}
+
+static inline void wheel_list_unlink(wheel_link_t* link) {
+    link->prev->next = link->next;
+    link->next->prev = link->prev;
+    link->next = link;
+    link->prev = link;
+}
+
+static inline void wheel_list_add_tail(wheel_link_t* head, wheel_link_t* link) {
+    link->prev = head->prev;
+    link->next = head;
+    head->prev->next = link;
+    head->prev = link;
+}
+
+// Move every entry of one list onto an empty local list
+static void wheel_list_take(wheel_link_t* head, wheel_link_t* out) {
+    out->next = out;
+    out->prev = out;
+    if (wheel_list_empty(head)) {
+        return;
+    }
+    out->next = head->next;
+    out->prev = head->prev;
+    out->next->prev = out;
+    out->prev->next = out;
+    head->next = head;
+    head->prev = head;
+}
+
+// Link a timer into the slot for its expiry: the lowest level whose span
+// covers the distance from wheel_tick (at most WHEEL_LEVELS - 1 steps)
+static void wheel_link_timer(wheel_timer_t* timer) {
+    unsigned int delta = timer->expires - wheel_tick;
+    unsigned int level = 0;
+    while (level < WHEEL_LEVELS - 1 && delta >= (1U << (WHEEL_BITS * (level + 1)))) {
+        level++;
+    }
+    unsigned int slot = (timer->expires >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    wheel_list_add_tail(&wheel_slots[level][slot], &timer->link);
+}
+
+// Re-link the timers of the current slot of a higher level one level down
+// Returns: that slot's index (0 means the next level up is due as well)
+static unsigned int wheel_cascade(unsigned int level) {
+    unsigned int slot = (wheel_tick >> (WHEEL_BITS * level)) & WHEEL_MASK;
+    wheel_link_t pending;
+    wheel_list_take(&wheel_slots[level][slot], &pending);
+    while (!wheel_list_empty(&pending)) {
+        wheel_timer_t* timer = (wheel_timer_t*)pending.next;
+        wheel_list_unlink(&timer->link);
+        wheel_link_timer(timer);
+    }
+    return slot;
+}
+
+// Process every tick up to the current tick count (interrupts disabled)
+static void wheel_run_expired(void) {
+    unsigned int now = timer_ticks();
+    
+    // Nothing armed: skip the idle stretch instead of walking it
+    if (wheel_armed == 0) {
+        wheel_tick = now + 1;
+        return;
+    }
+    
+    while ((int)(now - wheel_tick) >= 0) {
+        unsigned int slot = wheel_tick & WHEEL_MASK;
+        if (slot == 0) {
+            for (unsigned int level = 1; level < WHEEL_LEVELS; level++) {
+                if (wheel_cascade(level) != 0) {
+                    break;
+                }
+            }
+        }
+    
+        // Callbacks may re-arm timers, so detach the slot before running it
+        wheel_link_t due;
+        wheel_list_take(&wheel_slots[0][slot], &due);
+        while (!wheel_list_empty(&due)) {
+            wheel_timer_t* timer = (wheel_timer_t*)due.next;
+            wheel_list_unlink(&timer->link);
+            if (timer->period != 0) {
+                timer->expires = wheel_tick + timer->period;
+                wheel_link_timer(timer);
+            } else {
+                timer->armed = 0;
+                wheel_armed--;
+            }
+            timer->callback(timer->arg);
+        }
+        wheel_tick++;
+    }
+}
+
+// Timer tick hook
+static void wheel_tick_handler(interrupt_frame_t* frame) {
+    (void)frame;
+    wheel_run_expired();
+}
+
+void wheel_init(void) {
+    for (unsigned int level = 0; level < WHEEL_LEVELS; level++) {
+        for (unsigned int slot = 0; slot < WHEEL_SLOTS; slot++) {
+            wheel_slots[level][slot].next = &wheel_slots[level][slot];
+            wheel_slots[level][slot].prev = &wheel_slots[level][slot];
+        }
+    }
+    wheel_tick = timer_ticks() + 1;
+    wheel_armed = 0;
+    wheel_initialized = 1;
+    
+    if (timer_register_tick(wheel_tick_handler) != 0) {
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_FAILURE, -1, -1, "Failed to register timing wheel tick");
+    }
+}
+
+int wheel_timer_arm(wheel_timer_t* timer, unsigned int delay, unsigned int period,
+                    wheel_callback_t callback, void* arg) {
+    if (!wheel_initialized || timer == 0 || callback == 0) {
+        return -1;
+    }
+    if (delay > WHEEL_MAX_TICKS) {
+        delay = WHEEL_MAX_TICKS;
+    }
+    if (period > WHEEL_MAX_TICKS) {
+        period = WHEEL_MAX_TICKS;
+    }
+    
+    unsigned long flags = interrupts_save();
+    if (timer->armed) {
+        wheel_list_unlink(&timer->link);
+    } else {
+        wheel_armed++;
+    }
+    
+    timer->callback = callback;
+    timer->arg = arg;
+    timer->period = period;
+    timer->expires = timer_ticks() + delay;
+    if ((int)(timer->expires - wheel_tick) < 0) {
+        timer->expires = wheel_tick;
+    }
+    timer->armed = 1;
+    wheel_link_timer(timer);
+    interrupts_restore(flags);
+    return 0;
+}
+
+int wheel_timer_cancel(wheel_timer_t* timer) {
+    if (timer == 0) {
+        return 0;
+    }
+    
+    unsigned long flags = interrupts_save();
+    int was_armed = timer->armed;
+    if (was_armed) {
+        wheel_list_unlink(&timer->link);
+        timer->armed = 0;
+        wheel_armed--;
+    }
+    interrupts_restore(flags);
+    return was_armed;
+}
+
+unsigned int wheel_ms_to_ticks(unsigned int ms) {
+    unsigned int hz = timer_hz();
+    if (hz == 0) {
+        hz = TIMER_HZ;
+    }
+    // Split so ms * hz cannot overflow for any ms
+    return (ms / 1000) * hz + ((ms % 1000) * hz + 999) / 1000;
+}
+
+unsigned int wheel_next_due(void) {
+    wheel_run_expired();
+    if (wheel_armed == 0) {
+        return WHEEL_NONE;
+    }
+    
+    // Exact expiry from level 0, else the next cascade: timers on higher
+    // levels cannot fire before it, and it comes within WHEEL_SLOTS ticks
+    unsigned int due = (wheel_tick + WHEEL_MASK) & ~WHEEL_MASK;
+    for (unsigned int k = 0; k < WHEEL_SLOTS; k++) {
+        if (!wheel_list_empty(&wheel_slots[0][(wheel_tick + k) & WHEEL_MASK])) {
+            if ((int)(wheel_tick + k - due) < 0) {
+                due = wheel_tick + k;
+            }
+            break;
+        }
+    }
+    
+    // wheel_tick is the next tick (now + 1), so the result is at least 1
+    return due - timer_ticks();
+}
+
+void wheel_idle(void) {
+    unsigned long flags = interrupts_save();
+    timer_idle(wheel_next_due());
+    interrupts_restore(flags);
+}
@@ -0,0 +1,65 @@
+// AgentOS Timing Wheel Module
+// Week 3: Hierarchical timing wheel driven by the timer tick, with tickless idle
+
+#ifndef WHEEL_H
+#define WHEEL_H
+
+// Wheel geometry: WHEEL_LEVELS levels of WHEEL_SLOTS slots; level n slots
+// are WHEEL_SLOTS^n ticks wide, so delays up to WHEEL_MAX_TICKS fit
+#define WHEEL_BITS 6
+#define WHEEL_SLOTS (1U << WHEEL_BITS)
+#define WHEEL_LEVELS 4
+#define WHEEL_MAX_TICKS ((1U << (WHEEL_BITS * WHEEL_LEVELS)) - 1)
+
+// wheel_next_due() result when no timer is armed
+#define WHEEL_NONE 0xFFFFFFFFU
+
+// Expiry callback; runs in the timer interrupt (or in wheel_next_due()'s
+// caller) with interrupts disabled, so it must be short and must not block
+typedef void (*wheel_callback_t)(void* arg);
+
+// Intrusive list link (slots are circular lists with a sentinel)
+typedef struct wheel_link {
+    struct wheel_link* next;
+    struct wheel_link* prev;
+} wheel_link_t;
+
+// Timer owned by the caller (no allocation, start zeroed); the link must come first
+typedef struct {
+    wheel_link_t link;
+    unsigned int expires;        // Absolute tick
+    unsigned int period;         // Re-arm interval in ticks (0 = one-shot)
+    wheel_callback_t callback;
+    void* arg;
+    int armed;
+} wheel_timer_t;
+
+// Initialize the wheel and hook it into the timer tick
+// Requires timer_init()
+void wheel_init(void);
+
+// Arm (or re-arm) a timer to fire after delay ticks, then every period
+// ticks if period is non-zero; delays are clamped to WHEEL_MAX_TICKS
+// O(1): the timer is linked into one slot of one level
+// Returns: 0 on success, -1 on invalid timer or callback
+int wheel_timer_arm(wheel_timer_t* timer, unsigned int delay, unsigned int period,
+                    wheel_callback_t callback, void* arg);
+
+// Disarm a timer if it is armed (O(1) unlink)
+// Returns: 1 if it was armed, 0 otherwise
+int wheel_timer_cancel(wheel_timer_t* timer);
+
+// Convert milliseconds to ticks at the current timer rate (rounded up)
+unsigned int wheel_ms_to_ticks(unsigned int ms);
+
+// Run every timer that is due, then report how many ticks from now the
+// next one may fire (1 = on the next tick, WHEEL_NONE if none is armed)
+// Must be called with interrupts disabled
+unsigned int wheel_next_due(void);
+
+// Halt until the next timer is due or another interrupt arrives; the
+// periodic tick is stopped meanwhile (timer_idle()), so idle time costs
+// no interrupts
+void wheel_idle(void);
+
+#endif // WHEEL_H
@@ -0,0 +1,90 @@
+// AgentOS Kernel Tracing Module Implementation
+// Week 3: Static tracepoints recorded into per-CPU rings, exported over serial
+
+#include "trace.h"
+
+#ifdef CONFIG_TRACE
+
+#include "serial.h"
+#include "clock/clock.h"
+#include "lib/format.h"
+
+// One trace record (16 bytes)
+typedef struct {
+    unsigned long long tsc;      // TSC at the tracepoint
+    unsigned short point;        // trace_point_t
+    unsigned char phase;         // TRACE_PHASE_BEGIN or TRACE_PHASE_END
+    unsigned char cpu;           // CPU that recorded it
+    int arg;                     // Tracepoint argument
+} trace_record_t;
+
+// Per-CPU ring: only its own CPU writes to it, so reserving a slot is a single
+// atomic increment that an interrupt handler on the same CPU cannot tear
+typedef struct {
+    unsigned int head;                           // Total records ever reserved
+    trace_record_t records[TRACE_RING_SIZE];
+} trace_ring_t;
+
+// Rings (fixed-size, no heap)
+static trace_ring_t trace_rings[TRACE_MAX_CPUS];
+
+// Tracepoint names used in the export (Chrome trace-event "name")
+static const char* trace_point_names[TRACE_POINT_MAX] = {
+    "agent_run",
+    "sys_intent_submit",
+    "audit_emit",
+    "intent_handler",
+    "vga_write",
+};
+
+// Current CPU index (single CPU until SMP bring-up)
+static inline unsigned int trace_cpu_id(void) {
+    return 0;
+}
+
+void trace_record(trace_point_t point, char phase, int arg) {
+    trace_ring_t* ring = &trace_rings[trace_cpu_id()];
+    unsigned int slot = __atomic_fetch_add(&ring->head, 1, __ATOMIC_RELAXED) & (TRACE_RING_SIZE - 1);
+    trace_record_t* record = &ring->records[slot];
+    
+    record->tsc = clock_cycles();
+    record->point = (unsigned short)point;
+    record->phase = (unsigned char)phase;
+    record->cpu = (unsigned char)trace_cpu_id();
+    record->arg = arg;
+}
+
+void trace_export_serial(void) {
+    char line[96];
+    
+    // Header: "TRACE-BEGIN khz=<hex> boot=<hex>"
+    ksnprintf(line, 96, "TRACE-BEGIN khz=%08x boot=%016llx\n",
+              clock_cycles_per_ms(), clock_boot_cycles());
+    serial_write(line);
+    
+    // Records: "T <cpu> <tsc> <phase> <name> <arg>" (numbers in hex)
+    for (unsigned int cpu = 0; cpu < TRACE_MAX_CPUS; cpu++) {
+        trace_ring_t* ring = &trace_rings[cpu];
+        unsigned int head = ring->head;
+        unsigned int first = head > TRACE_RING_SIZE ? head - TRACE_RING_SIZE : 0;
+        
+        for (unsigned int n = first; n < head; n++) {
+            const trace_record_t* record = &ring->records[n & (TRACE_RING_SIZE - 1)];
+            ksnprintf(line, 96, "T %02x %016llx %c %s %08x\n",
+                      record->cpu, record->tsc, record->phase,
+                      record->point < TRACE_POINT_MAX ? trace_point_names[record->point] : "unknown",
+                      (unsigned int)record->arg);
+            serial_write(line);
+        }
+    }
+    
+    serial_write("TRACE-END\n");
+}
+
+#else
+
+void trace_export_serial(void) {
+    // Tracing compiled out (build with TRACE=1)
+}
+
+#endif // CONFIG_TRACE
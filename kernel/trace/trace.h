@@ -0,0 +1,45 @@
+// AgentOS Kernel Tracing Module
+// Week 3: Static tracepoints recorded into per-CPU rings, exported over serial
+
+#ifndef TRACE_H
+#define TRACE_H
+
+// Tracing is opt-in: build with `make TRACE=1` to define CONFIG_TRACE.
+// Without it every tracepoint compiles to nothing.
+
+// Records per CPU ring (power of two; oldest records are overwritten)
+#define TRACE_RING_SIZE 4096
+
+// Number of per-CPU rings (single CPU today)
+#define TRACE_MAX_CPUS 1
+
+// Static tracepoints
+typedef enum {
+    TRACE_AGENT_RUN = 0,         // agent_run() (arg: agent ID)
+    TRACE_INTENT_SUBMIT,         // sys_intent_submit() after validation (arg: intent action)
+    TRACE_AUDIT_EMIT,            // audit_emit() record write (arg: audit type)
+    TRACE_HANDLER,               // Intent handler call (arg: intent action)
+    TRACE_VGA_WRITE,             // vga_write() (arg: unused)
+    TRACE_POINT_MAX              // Sentinel value
+} trace_point_t;
+
+// Trace record phases (Chrome trace-event "ph" values)
+#define TRACE_PHASE_BEGIN 'B'
+#define TRACE_PHASE_END   'E'
+
+// Append a record to the current CPU's ring (lock-free, interrupt-safe slot reservation)
+void trace_record(trace_point_t point, char phase, int arg);
+
+// Write all rings to serial, oldest to newest, between TRACE-BEGIN/TRACE-END markers
+// Convert with tools/trace2chrome.py. Does nothing when tracing is compiled out.
+void trace_export_serial(void);
+
+#ifdef CONFIG_TRACE
+#define TRACE_BEGIN(point, arg) trace_record((point), TRACE_PHASE_BEGIN, (arg))
+#define TRACE_END(point, arg)   trace_record((point), TRACE_PHASE_END, (arg))
+#else
+#define TRACE_BEGIN(point, arg) do { (void)(arg); } while (0)
+#define TRACE_END(point, arg)   do { (void)(arg); } while (0)
+#endif
+
+#endif // TRACE_H
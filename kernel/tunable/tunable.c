@@ -0,0 +1,232 @@
+// AgentOS Tunables Module Implementation
+// Week 3: Typed per-boot tunables parsed from the Multiboot2 kernel command line
+
+#include "tunable.h"
+#include "agent/agent.h"    // For AGENT_MAX_COUNT, AGENT_DEFAULT_BUDGET_MS
+#include "audit/audit.h"    // For AUDIT_MAX_EVENTS
+#include "intent/intent.h"  // For INTENT_PAYLOAD_MAX
+#include "timer/timer.h"    // For TIMER_HZ
+#include "serial.h"
+#include "lib/string.h"
+#include "lib/format.h"
+
+// Names accepted by TUNABLE_AUDIT (index = value)
+static const char* const tunable_audit_names[] = { "all", "errors", 0 };
+
+// Registry entry: the name used on the command line, its type, its
+// default and valid range (CHOICE: index into names)
+typedef struct {
+    const char* name;
+    tunable_type_t type;
+    unsigned int def;
+    unsigned int min;
+    unsigned int max;
+    const char* const* names;    // CHOICE only, null-terminated
+} tunable_desc_t;
+
+static const tunable_desc_t tunable_descs[TUNABLE_MAX] = {
+    [TUNABLE_TIMER_HZ]     = { "timer_hz", TUNABLE_TYPE_UINT, TIMER_HZ, 20, 10000, 0 },
+    [TUNABLE_BUDGET_MS]    = { "budget_ms", TUNABLE_TYPE_UINT, AGENT_DEFAULT_BUDGET_MS, 0, 3600000, 0 },
+    [TUNABLE_AGENTS]       = { "agents", TUNABLE_TYPE_UINT, AGENT_MAX_COUNT, 1, AGENT_MAX_COUNT, 0 },
+    [TUNABLE_AUDIT_EVENTS] = { "audit_events", TUNABLE_TYPE_UINT, AUDIT_MAX_EVENTS, 1, AUDIT_MAX_EVENTS, 0 },
+    [TUNABLE_AUDIT]        = { "audit", TUNABLE_TYPE_CHOICE, TUNABLE_AUDIT_ALL, 0, 1, tunable_audit_names },
+    [TUNABLE_PAYLOAD_MAX]  = { "payload_max", TUNABLE_TYPE_UINT, INTENT_PAYLOAD_MAX, 2, INTENT_PAYLOAD_MAX, 0 },
+    [TUNABLE_SNAPSHOT]     = { "snapshot", TUNABLE_TYPE_BOOL, 1, 0, 1, 0 },
+};
+
+// Values set from the command line (valid where tunable_set_mask has the bit)
+static unsigned int tunable_values[TUNABLE_MAX];
+static unsigned int tunable_set_mask = 0;
+
+// Rejected tokens (pointers into the command line, which stays in place)
+typedef struct {
+    const char* text;
+    unsigned int len;
+} tunable_token_t;
+
+static tunable_token_t tunable_rejects[TUNABLE_REJECT_MAX];
+static unsigned int tunable_reject_count = 0;
+
+// Does [s, s + len) spell name exactly
+static int tunable_equal(const char* s, unsigned int len, const char* name) {
+    return strlen(name) == len && memcmp(s, name, len) == 0;
+}
+
+// Parse an unsigned decimal or 0x-prefixed hex number filling [s, s + len)
+// Returns: 0 on success, -1 on an empty string, a stray character or overflow
+static int tunable_parse_uint(const char* s, unsigned int len, unsigned int* out) {
+    unsigned int base = 10;
+    if (len > 2 && s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) {
+        base = 16;
+        s += 2;
+        len -= 2;
+    }
+    if (len == 0) {
+        return -1;
+    }
+    
+    unsigned int value = 0;
+    for (unsigned int i = 0; i < len; i++) {
+        char c = s[i];
+        unsigned int digit;
+        if (c >= '0' && c <= '9') {
+            digit = (unsigned int)(c - '0');
+        } else if (base == 16 && c >= 'a' && c <= 'f') {
+            digit = (unsigned int)(c - 'a' + 10);
+        } else if (base == 16 && c >= 'A' && c <= 'F') {
+            digit = (unsigned int)(c - 'A' + 10);
+        } else {
+            return -1;
+        }
+        if (value > (0xFFFFFFFFU - digit) / base) {
+            return -1;
+        }
+        value = value * base + digit;
+    }
+    *out = value;
+    return 0;
+}
+
+// Parse a value for one tunable
+// Returns: 0 on success, -1 if it is not valid for the tunable's type and range
+static int tunable_parse_value(const tunable_desc_t* desc, const char* s, unsigned int len, unsigned int* out) {
+    switch (desc->type) {
+        case TUNABLE_TYPE_UINT:
+            if (tunable_parse_uint(s, len, out) != 0 || *out < desc->min || *out > desc->max) {
+                return -1;
+            }
+            return 0;
+        case TUNABLE_TYPE_BOOL:
+            if (tunable_equal(s, len, "1") || tunable_equal(s, len, "on") || tunable_equal(s, len, "yes")) {
+                *out = 1;
+                return 0;
+            }
+            if (tunable_equal(s, len, "0") || tunable_equal(s, len, "off") || tunable_equal(s, len, "no")) {
+                *out = 0;
+                return 0;
+            }
+            return -1;
+        case TUNABLE_TYPE_CHOICE:
+            for (unsigned int i = 0; desc->names[i] != 0; i++) {
+                if (tunable_equal(s, len, desc->names[i])) {
+                    *out = i;
+                    return 0;
+                }
+            }
+            return -1;
+    }
+    return -1;
+}
+
+// Apply one "name=value" token
+// Returns: 0 if applied, -1 if rejected
+static int tunable_apply(const char* token, unsigned int len, unsigned int eq) {
+    for (unsigned int id = 0; id < TUNABLE_MAX; id++) {
+        const tunable_desc_t* desc = &tunable_descs[id];
+        if (!tunable_equal(token, eq, desc->name)) {
+            continue;
+        }
+        unsigned int value;
+        if (tunable_parse_value(desc, token + eq + 1, len - eq - 1, &value) != 0) {
+            return -1;
+        }
+        tunable_values[id] = value;
+        tunable_set_mask |= 1U << id;
+        return 0;
+    }
+    return -1;  // Unknown name
+}
+
+void tunable_init(const char* cmdline) {
+    if (cmdline == 0) {
+        return;
+    }
+    
+    const char* p = cmdline;
+    while (*p != '\0') {
+        while (*p == ' ' || *p == '\t') {
+            p++;
+        }
+        const char* token = p;
+        unsigned int len = 0;
+        unsigned int eq = 0;
+        while (token[len] != '\0' && token[len] != ' ' && token[len] != '\t') {
+            if (token[len] == '=' && eq == 0) {
+                eq = len;
+            }
+            len++;
+        }
+        p = token + len;
+    
+        // Plain words (no '=') are left for whoever else reads the command line
+        if (len == 0 || eq == 0) {
+            continue;
+        }
+        if (tunable_apply(token, len, eq) != 0) {
+            if (tunable_reject_count < TUNABLE_REJECT_MAX) {
+                tunable_rejects[tunable_reject_count].text = token;
+                tunable_rejects[tunable_reject_count].len = len;
+            }
+            tunable_reject_count++;
+        }
+    }
+}
+
+unsigned int tunable_get(tunable_id_t id) {
+    if ((unsigned int)id >= TUNABLE_MAX) {
+        return 0;
+    }
+    // Defaults need no initialization, so modules may read them at any time
+    return (tunable_set_mask & (1U << id)) ? tunable_values[id] : tunable_descs[id].def;
+}
+
+// Format a value of one tunable (CHOICE values by name)
+static void tunable_format_value(char* buf, unsigned int size, unsigned int id, unsigned int value) {
+    const tunable_desc_t* desc = &tunable_descs[id];
+    if (desc->type == TUNABLE_TYPE_CHOICE) {
+        ksnprintf(buf, size, "%s", desc->names[value]);
+    } else {
+        ksnprintf(buf, size, "%u", value);
+    }
+}
+
+void tunable_audit(void) {
+    char audit_msg[AUDIT_MSG_MAX];
+    char value[16];
+    char def[16];
+    
+    for (unsigned int id = 0; id < TUNABLE_MAX; id++) {
+        if (!(tunable_set_mask & (1U << id))) {
+            continue;
+        }
+        tunable_format_value(value, sizeof(value), id, tunable_values[id]);
+        tunable_format_value(def, sizeof(def), id, tunable_descs[id].def);
+        ksnprintf(audit_msg, sizeof(audit_msg), "Tunable %s=%s (default %s)",
+                  tunable_descs[id].name, value, def);
+        audit_emit(AUDIT_TYPE_SYSTEM_INIT, AUDIT_RESULT_SUCCESS, -1, -1, audit_msg);
+    }
+    
+    // Rejected tokens are quoted (truncated to fit) so the typo is visible
+    for (unsigned int i = 0; i < tunable_reject_count && i < TUNABLE_REJECT_MAX; i++) {
+        char token[48];
+        unsigned int len = tunable_rejects[i].len < sizeof(token) - 1 ? tunable_rejects[i].len : sizeof(token) - 1;
+        memcpy(token, tunable_rejects[i].text, len);
+        token[len] = '\0';
+        ksnprintf(audit_msg, sizeof(audit_msg), "Tunable rejected (unknown or invalid): %s", token);
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_DENY, -1, -1, audit_msg);
+    }
+    if (tunable_reject_count > TUNABLE_REJECT_MAX) {
+        ksnprintf(audit_msg, sizeof(audit_msg), "%u more tunables rejected", tunable_reject_count - TUNABLE_REJECT_MAX);
+        audit_emit(AUDIT_TYPE_SYSTEM_ERROR, AUDIT_RESULT_DENY, -1, -1, audit_msg);
+    }
+}
+
+void tunable_export_serial(void) {
+    char line[64];
+    char value[16];
+    for (unsigned int id = 0; id < TUNABLE_MAX; id++) {
+        tunable_format_value(value, sizeof(value), id, tunable_get((tunable_id_t)id));
+        ksnprintf(line, sizeof(line), "TUNABLE %s %s\n", tunable_descs[id].name, value);
+        serial_write(line);
+    }
+}
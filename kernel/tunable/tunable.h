@@ -0,0 +1,54 @@
+// AgentOS Tunables Module
+// Week 3: Typed per-boot tunables parsed from the Multiboot2 kernel command line
+
+#ifndef TUNABLE_H
+#define TUNABLE_H
+
+// Command-line tokens remembered for the audit log when rejected (later
+// rejections are only counted)
+#define TUNABLE_REJECT_MAX 4
+
+// Value types
+typedef enum {
+    TUNABLE_TYPE_UINT = 0,       // Decimal or 0x hex, checked against [min, max]
+    TUNABLE_TYPE_BOOL,           // 0/1, off/on, no/yes
+    TUNABLE_TYPE_CHOICE          // One of a fixed list of names (value = index)
+} tunable_type_t;
+
+// Registered tunables. Tables stay fixed-size (no heap), so capacities are
+// limits within their compile-time maximum rather than new sizes
+typedef enum {
+    TUNABLE_TIMER_HZ = 0,        // timer_hz: periodic tick rate (scheduler quantum)
+    TUNABLE_BUDGET_MS,           // budget_ms: default agent CPU budget (0 = unlimited)
+    TUNABLE_AGENTS,              // agents: usable agent slots (<= AGENT_MAX_COUNT)
+    TUNABLE_AUDIT_EVENTS,        // audit_events: audit ring capacity (<= AUDIT_MAX_EVENTS)
+    TUNABLE_AUDIT,               // audit: "all" records, or only "errors" (no successful intents)
+    TUNABLE_PAYLOAD_MAX,         // payload_max: intent payload limit incl. terminator (<= INTENT_PAYLOAD_MAX)
+    TUNABLE_SNAPSHOT,            // snapshot: use the snapshot disk (0 = always boot cold, never write)
+    TUNABLE_MAX
+} tunable_id_t;
+
+// TUNABLE_AUDIT values
+#define TUNABLE_AUDIT_ALL 0
+#define TUNABLE_AUDIT_ERRORS 1
+
+// Parse "name=value" tokens separated by spaces (e.g. the Multiboot2
+// command line); tokens without '=' are ignored. Every tunable starts at its
+// default; a token with an unknown name or an invalid or out-of-range value
+// is rejected and leaves the tunable unchanged.
+// Needs no other module, so it runs right after multiboot_init(), before
+// the modules that read tunables in their init
+void tunable_init(const char* cmdline);
+
+// Get a tunable's value (its default if id is invalid or it was not set)
+unsigned int tunable_get(tunable_id_t id);
+
+// Audit what tunable_init() did: one record per value set from the command
+// line and per rejected token (call once audit_init() has run)
+void tunable_audit(void);
+
+// Write every tunable to serial as "TUNABLE <name> <value>" lines, so
+// benchmark results carry the configuration they ran with
+void tunable_export_serial(void);
+
+#endif // TUNABLE_H
@@ -0,0 +1,269 @@
+// AgentOS Ring-3 Agent Library Implementation
+// Week 3: Intent submission and the syscall benchmark agent (all USER_TEXT)
+
+#include "user.h"
+#include "syscall/syscall.h"
+#include "arch/x86_64/paging.h"  // For PAGING_AGENT_WINDOW, PAGING_AUDIT_VIEW
+
+// Round trips per entry path in user_bench_entry
+#define USER_BENCH_ROUNDS 2000
+
+// Intents per scenario in user_bench_entry (flood and deny storm)
+#define USER_BENCH_INTENTS 500
+
+// Kernel string helpers are not mapped in ring 3, so keep a private strnlen
+USER_TEXT static unsigned long user_strnlen(const char* s, unsigned long max) {
+    unsigned long len = 0;
+    while (len < max && s[len] != '\0') {
+        len++;
+    }
+    return len;
+}
+
+// rdtsc is allowed in ring 3 (CR4.TSD is clear)
+USER_TEXT static unsigned long long user_rdtsc(void) {
+    unsigned int lo, hi;
+    __asm__ volatile ("rdtsc" : "=a"(lo), "=d"(hi));
+    return ((unsigned long long)hi << 32) | lo;
+}
+
+USER_TEXT long user_intent_submit(int action, const char* payload) {
+    // The kernel rejects the call if the payload would not fit
+    unsigned long len = user_strnlen(payload, INTENT_PAYLOAD_MAX);
+    return user_syscall(SYS_NR_INTENT_SUBMIT, (unsigned long)action, (unsigned long)payload, len);
+}
+
+USER_TEXT int user_audit_next(unsigned int* next_seq, audit_event_t* out) {
+    const audit_view_t* view = (const audit_view_t*)PAGING_AUDIT_VIEW;
+    
+    for (;;) {
+        unsigned int seq = view->header.seq;
+        if (seq & 1) {
+            continue;  // Writer mid-record
+        }
+        __asm__ volatile ("" : : : "memory");
+        
+        unsigned int total = view->header.total_count;
+        unsigned int capacity = view->header.capacity;
+        unsigned int next = *next_seq;
+        if (total - next > capacity) {
+            next = total - capacity;  // Overwritten; resume at the oldest kept
+        }
+        
+        // Byte copy: no kernel memcpy in ring 3
+        int copied = 0;
+        if (next != total) {
+            const unsigned char* src = (const unsigned char*)&view->events[next % capacity];
+            unsigned char* dst = (unsigned char*)out;
+            for (unsigned long i = 0; i < sizeof(audit_event_t); i++) {
+                dst[i] = src[i];
+            }
+            copied = 1;
+        }
+        
+        __asm__ volatile ("" : : : "memory");
+        if (view->header.seq != seq) {
+            continue;  // A record was written meanwhile; the copy may be torn
+        }
+        
+        *next_seq = next + copied;
+        return copied;
+    }
+}
+
+// Intent payload words (string literals would land in kernel .rodata)
+static const char user_channel_send_verb[] USER_RODATA = "send ";
+static const char user_channel_recv_verb[] USER_RODATA = "recv ";
+static const char user_shm_create_verb[] USER_RODATA = "create ";
+static const char user_shm_huge_word[] USER_RODATA = "huge";
+static const char user_shm_map_verb[] USER_RODATA = "map ";
+static const char user_shm_read_word[] USER_RODATA = " r";
+static const char user_shm_write_word[] USER_RODATA = "w";
+static const char user_console_focus_verb[] USER_RODATA = "focus ";
+static const char user_console_kernel_word[] USER_RODATA = "kernel";
+static const char user_bench_sleep_payload[] USER_RODATA = "0";
+static const char user_bench_profile_payload[] USER_RODATA = "dump";
+
+// Payloads are built on the stack (no formatter in ring 3); callers size
+// buf for the longest payload they build
+USER_TEXT static void user_append_str(char* buf, unsigned int* pos, const char* s) {
+    for (; *s != '\0'; s++) {
+        buf[(*pos)++] = *s;
+    }
+    buf[*pos] = '\0';
+}
+
+USER_TEXT static void user_append_uint(char* buf, unsigned int* pos, unsigned int value) {
+    char digits[10];
+    unsigned int n = 0;
+    do {
+        digits[n++] = (char)('0' + value % 10);
+        value /= 10;
+    } while (value != 0);
+    while (n > 0) {
+        buf[(*pos)++] = digits[--n];
+    }
+    buf[*pos] = '\0';
+}
+
+USER_TEXT long user_channel_open(int dir, int peer) {
+    // "send <peer>" / "recv <peer>"
+    char payload[16];
+    unsigned int pos = 0;
+    user_append_str(payload, &pos, dir == CHANNEL_DIR_SEND ? user_channel_send_verb : user_channel_recv_verb);
+    user_append_uint(payload, &pos, (unsigned int)peer);
+    return user_intent_submit(INTENT_CHANNEL_OPEN, payload);
+}
+
+USER_TEXT long user_shm_create(unsigned int pages, int huge) {
+    // "create <pages>" / "create huge"
+    char payload[24];
+    unsigned int pos = 0;
+    user_append_str(payload, &pos, user_shm_create_verb);
+    if (huge) {
+        user_append_str(payload, &pos, user_shm_huge_word);
+    } else {
+        user_append_uint(payload, &pos, pages);
+    }
+    return user_intent_submit(INTENT_SHM_CONTROL, payload);
+}
+
+USER_TEXT long user_shm_map(int region, int agent_id, int writable) {
+    // "map <region> <id> r|rw"
+    char payload[24];
+    unsigned int pos = 0;
+    user_append_str(payload, &pos, user_shm_map_verb);
+    user_append_uint(payload, &pos, (unsigned int)region);
+    payload[pos++] = ' ';
+    user_append_uint(payload, &pos, (unsigned int)agent_id);
+    user_append_str(payload, &pos, user_shm_read_word);
+    if (writable) {
+        user_append_str(payload, &pos, user_shm_write_word);
+    }
+    return user_intent_submit(INTENT_SHM_CONTROL, payload);
+}
+
+USER_TEXT long user_console_read(unsigned int timeout_ms) {
+    // "" (until the intent deadline) / "<ms>"
+    char payload[12];
+    unsigned int pos = 0;
+    payload[0] = '\0';
+    if (timeout_ms != 0) {
+        user_append_uint(payload, &pos, timeout_ms);
+    }
+    return user_intent_submit(INTENT_CONSOLE_READ, payload);
+}
+
+USER_TEXT long user_console_focus(int console_id) {
+    // "focus <id>" / "focus kernel"
+    char payload[16];
+    unsigned int pos = 0;
+    user_append_str(payload, &pos, user_console_focus_verb);
+    if (console_id == CONSOLE_KERNEL) {
+        user_append_str(payload, &pos, user_console_kernel_word);
+    } else {
+        user_append_uint(payload, &pos, (unsigned int)console_id);
+    }
+    return user_intent_submit(INTENT_CONSOLE_CONTROL, payload);
+}
+
+USER_TEXT int user_channel_send(int peer, const void* msg, unsigned int len) {
+    channel_ring_t* ring = (channel_ring_t*)CHANNEL_SEND_VIEW(peer);
+    if (len > CHANNEL_MSG_MAX) {
+        return -1;
+    }
+    
+    // Only reread the consumer's line when the cached tail says full
+    unsigned int head = ring->head;
+    if (head - ring->tail_cache >= CHANNEL_SLOTS) {
+        ring->tail_cache = ring->tail;
+        if (head - ring->tail_cache >= CHANNEL_SLOTS) {
+            return -1;
+        }
+    }
+    
+    channel_msg_t* slot = &ring->slots[head % CHANNEL_SLOTS];
+    const unsigned char* src = (const unsigned char*)msg;
+    for (unsigned int i = 0; i < len; i++) {
+        slot->data[i] = src[i];
+    }
+    slot->len = len;
+    
+    // Publish the slot after its contents (x86 keeps stores in order)
+    __asm__ volatile ("" : : : "memory");
+    ring->head = head + 1;
+    return 0;
+}
+
+USER_TEXT int user_channel_recv(int peer, void* buf, unsigned int max) {
+    channel_ring_t* ring = (channel_ring_t*)CHANNEL_RECV_VIEW(peer);
+    
+    // Only reread the producer's line when the cached head says empty
+    unsigned int tail = ring->tail;
+    if (ring->head_cache == tail) {
+        ring->head_cache = ring->head;
+        if (ring->head_cache == tail) {
+            return -1;
+        }
+    }
+    __asm__ volatile ("" : : : "memory");
+    
+    // The producer controls len; never copy past the slot or the buffer
+    const channel_msg_t* slot = &ring->slots[tail % CHANNEL_SLOTS];
+    unsigned int len = slot->len;
+    if (len > CHANNEL_MSG_MAX) {
+        len = CHANNEL_MSG_MAX;
+    }
+    unsigned char* dst = (unsigned char*)buf;
+    for (unsigned int i = 0; i < len && i < max; i++) {
+        dst[i] = slot->data[i];
+    }
+    
+    // Hand the slot back only after it has been read
+    __asm__ volatile ("" : : : "memory");
+    ring->tail = tail + 1;
+    return (int)len;
+}
+
+USER_TEXT void user_bench_entry(void* context) {
+    (void)context;
+    user_bench_result_t* result = (user_bench_result_t*)PAGING_AGENT_WINDOW;
+    
+    // Warm up both paths (TLB, caches, branch predictors)
+    for (unsigned int i = 0; i < 16; i++) {
+        user_syscall(SYS_NR_NOP, 0, 0, 0);
+        user_syscall_int80(SYS_NR_NOP, 0, 0, 0);
+    }
+    
+    unsigned long long start = user_rdtsc();
+    for (unsigned int i = 0; i < USER_BENCH_ROUNDS; i++) {
+        user_syscall(SYS_NR_NOP, 0, 0, 0);
+    }
+    result->fast_cycles = user_rdtsc() - start;
+    
+    start = user_rdtsc();
+    for (unsigned int i = 0; i < USER_BENCH_ROUNDS; i++) {
+        user_syscall_int80(SYS_NR_NOP, 0, 0, 0);
+    }
+    result->int80_cycles = user_rdtsc() - start;
+    
+    result->rounds = USER_BENCH_ROUNDS;
+    
+    // Intent flood: the whole submit path (copy-in, audit, stats, dispatch)
+    // with a zero sleep, which needs no capability and returns at once
+    start = user_rdtsc();
+    for (unsigned int i = 0; i < USER_BENCH_INTENTS; i++) {
+        user_intent_submit(INTENT_SLEEP, user_bench_sleep_payload);
+    }
+    result->flood_cycles = user_rdtsc() - start;
+    
+    // Deny storm: intents this agent holds no capability for (CAP_PROFILE),
+    // each refused and audited with a DENY record
+    start = user_rdtsc();
+    for (unsigned int i = 0; i < USER_BENCH_INTENTS; i++) {
+        user_intent_submit(INTENT_PROFILE_CONTROL, user_bench_profile_payload);
+    }
+    result->deny_cycles = user_rdtsc() - start;
+    
+    result->intents = USER_BENCH_INTENTS;
+}
@@ -0,0 +1,93 @@
+// AgentOS Ring-3 Agent Library
+// Week 3: Code that runs in agent (user) mode: system call stubs and helpers
+
+#ifndef USER_H
+#define USER_H
+
+#include "audit/audit.h"      // For audit_event_t, audit_view_t
+#include "channel/channel.h"  // For channel_ring_t, CHANNEL_*_VIEW
+#include "shm/shm.h"          // For SHM_VIEW
+#include "console/console.h"  // For CONSOLE_KERNEL
+
+// Place agent code and constants in the .user image, which is mapped
+// read-only at PAGING_USER_BASE in every agent address space
+// Ring-3 code may only call USER_TEXT functions and read USER_RODATA
+// constants, its stack, and its agent window; a kernel address faults
+// and terminates the agent
+#define USER_TEXT __attribute__((section(".user.text")))
+#define USER_RODATA __attribute__((section(".user.rodata")))
+
+// Fast system call (sysenter on i386, syscall on x86_64; stubs in arch/x86_64/usermode*.S)
+// Register ABI: number and up to three arguments, result in eax/rax
+long user_syscall(unsigned long nr, unsigned long a1, unsigned long a2, unsigned long a3);
+
+// Same call through the int 0x80 gate (kept for comparison and for exit)
+long user_syscall_int80(unsigned long nr, unsigned long a1, unsigned long a2, unsigned long a3);
+
+// Submit an intent with a NUL-terminated payload in agent memory
+// (USER_RODATA or the agent window); a payload of payload_max bytes or
+// more (the payload_max= tunable, at most INTENT_PAYLOAD_MAX) is rejected
+// Returns: sys_intent_submit() result (0, SYS_ERR_* or -1, also -1 for a
+// payload that is too long)
+long user_intent_submit(int action, const char* payload);
+
+// Copy the next audit event after *next_seq out of the read-only audit view
+// (agent must hold CAP_AUDIT_READ, or the first load faults). Lock-free:
+// retries until it reads a consistent snapshot. If the writer has lapped the
+// reader, *next_seq skips ahead to the oldest event still in the ring.
+// Returns: 1 and advances *next_seq if an event was copied, 0 if none is new
+int user_audit_next(unsigned int* next_seq, audit_event_t* out);
+
+// Open this agent's end of a channel with peer (INTENT_CHANNEL_OPEN,
+// dir = CHANNEL_DIR_SEND or CHANNEL_DIR_RECV); needs CAP_CHANNEL
+// Returns: user_intent_submit() result
+long user_channel_open(int dir, int peer);
+
+// Create a zeroed shared memory region of pages 4 KiB pages (or the huge
+// region) owned by this agent and mapped read/write at SHM_VIEW(region);
+// needs CAP_SHM
+// Returns: region ID, or a negative user_intent_submit() error
+long user_shm_create(unsigned int pages, int huge);
+
+// Map a region this agent holds rights on into another agent (which needs
+// CAP_SHM) at SHM_VIEW(region), read-only unless writable
+// Returns: user_intent_submit() result
+long user_shm_map(int region, int agent_id, int writable);
+
+// Wait for the next typed byte (INTENT_CONSOLE_READ); the agent halts until
+// the keyboard IRQ delivers input, at most timeout_ms if non-zero; needs
+// CAP_CONSOLE_READ
+// Returns: the byte (1-255), 0 if timeout_ms passed first, or a negative
+// user_intent_submit() error (SYS_ERR_TIMEOUT at the intent deadline)
+long user_console_read(unsigned int timeout_ms);
+
+// Show a console on screen (INTENT_CONSOLE_CONTROL "focus <id>", or
+// "focus kernel" for CONSOLE_KERNEL); needs CAP_CONSOLE_CONTROL
+// Returns: user_intent_submit() result
+long user_console_focus(int console_id);
+
+// Send one message on the channel to peer (opened with INTENT_CHANNEL_OPEN
+// "send <peer>"); plain stores into the shared ring, no system call
+// Returns: 0 on success, -1 if the ring is full or len > CHANNEL_MSG_MAX
+int user_channel_send(int peer, const void* msg, unsigned int len);
+
+// Receive one message from the channel from peer ("recv <peer>") into buf
+// (at most max bytes are copied); plain loads, no system call
+// Returns: message length, or -1 if the ring is empty
+int user_channel_recv(int peer, void* buf, unsigned int max);
+
+// Result block written by user_bench_entry at the start of its window
+typedef struct {
+    unsigned int rounds;                 // Round trips per path
+    unsigned long long fast_cycles;      // Total cycles, sysenter/syscall
+    unsigned long long int80_cycles;     // Total cycles, int 0x80
+    unsigned int intents;                // Intents per scenario (0 = not reached)
+    unsigned long long flood_cycles;     // Total cycles, allowed intents back to back
+    unsigned long long deny_cycles;      // Total cycles, intents refused for a missing capability
+} user_bench_result_t;
+
+// Benchmark agent: times SYS_NR_NOP round trips through both entry paths,
+// then an intent flood and a deny storm through the full submit path
+void user_bench_entry(void* context);
+
+#endif // USER_H
@@ -2,6 +2,9 @@
 // Week 2 Day 1: Cursor-based console output
 
 #include "vga.h"
+#include "trace/trace.h"
+#include "arch/x86_64/io.h"
+#include "lib/string.h"
 
 // VGA text buffer starts at physical address 0xB8000
 // Each character is 2 bytes: [character] [attribute]
@@ -34,24 +37,128 @@
 // Default attribute: light grey on black
 #define VGA_DEFAULT_ATTR (VGA_COLOR_LIGHT_GREY | (VGA_COLOR_BLACK << 4))
 
+// Hardware cursor (CRT controller) ports and registers
+#define VGA_CRTC_INDEX 0x3D4
+#define VGA_CRTC_DATA  0x3D5
+#define VGA_CRTC_CURSOR_HIGH 0x0E
+#define VGA_CRTC_CURSOR_LOW  0x0F
+
 // Global cursor position (row, col)
 static unsigned int vga_cursor_row = 0;
 static unsigned int vga_cursor_col = 0;
 
+// RAM shadow of the text buffer; all writes land here first so MMIO is
+// touched only by vga_flush(), one whole row at a time
+static unsigned short vga_shadow[VGA_HEIGHT * VGA_WIDTH];
+
+// Rows changed since the last flush (bit N = row N; VGA_HEIGHT <= 32)
+static unsigned int vga_dirty_rows = 0;
+
+// Cursor position last written to the CRT controller
+static unsigned int vga_hw_cursor = 0xFFFFFFFF;
+
+// Nesting depth of vga_batch_begin()
+static unsigned int vga_batch_depth = 0;
+
+// All rows dirty
+#define VGA_ALL_ROWS ((1U << VGA_HEIGHT) - 1)
+
 // Get VGA buffer pointer
-static volatile unsigned short* vga_get_buffer(void) {
-    return (volatile unsigned short*)VGA_BUFFER_ADDR;
+// Not volatile: rows are copied with wide string stores by memcpy, and the
+// copy is ordered by the memory clobber in memcpy's inline assembly
+static unsigned short* vga_get_buffer(void) {
+    return (unsigned short*)VGA_BUFFER_ADDR;
 }
 
-// Clear a single row
+// Clear a single shadow row
 static void vga_clear_row(unsigned int row) {
-    volatile unsigned short* vga_buffer = vga_get_buffer();
-    unsigned int start_pos = row * VGA_WIDTH;
+    unsigned short* shadow_row = &vga_shadow[row * VGA_WIDTH];
+    for (unsigned int col = 0; col < VGA_WIDTH; col++) {
+        shadow_row[col] = VGA_ENTRY(' ', VGA_DEFAULT_ATTR);
+    }
+    vga_dirty_rows |= 1U << row;
+}
+
+// Scroll the shadow up one row (bulk move) and blank the bottom row
+static void vga_scroll(void) {
+    memmove(&vga_shadow[0], &vga_shadow[VGA_WIDTH],
+            (VGA_HEIGHT - 1) * VGA_WIDTH * sizeof(unsigned short));
+    vga_clear_row(VGA_HEIGHT - 1);
+    vga_dirty_rows = VGA_ALL_ROWS;
+}
+
+// Program the hardware cursor if it moved since the last flush
+static void vga_update_cursor(void) {
+    unsigned int pos = vga_cursor_row * VGA_WIDTH + vga_cursor_col;
+    if (pos == vga_hw_cursor) {
+        return;
+    }
+    outb(VGA_CRTC_INDEX, VGA_CRTC_CURSOR_LOW);
+    outb(VGA_CRTC_DATA, (unsigned char)(pos & 0xFF));
+    outb(VGA_CRTC_INDEX, VGA_CRTC_CURSOR_HIGH);
+    outb(VGA_CRTC_DATA, (unsigned char)((pos >> 8) & 0xFF));
+    vga_hw_cursor = pos;
+}
+
+void vga_flush(void) {
+    unsigned short* vga_buffer = vga_get_buffer();
+    unsigned int dirty = vga_dirty_rows;
+    vga_dirty_rows = 0;
+    
+    while (dirty != 0) {
+        unsigned int row = (unsigned int)__builtin_ctz(dirty);
+        dirty &= dirty - 1;
+        memcpy(&vga_buffer[row * VGA_WIDTH], &vga_shadow[row * VGA_WIDTH],
+               VGA_WIDTH * sizeof(unsigned short));
+    }
+    
+    vga_update_cursor();
+}
+
+void vga_draw_row(unsigned int row, const char* text) {
+    if (row >= VGA_HEIGHT || text == 0) {
+        return;
+    }
+    
+    unsigned short* shadow_row = &vga_shadow[row * VGA_WIDTH];
+    unsigned int changed = 0;
     for (unsigned int col = 0; col < VGA_WIDTH; col++) {
-        vga_buffer[start_pos + col] = VGA_ENTRY(' ', VGA_DEFAULT_ATTR);
+        unsigned short entry = VGA_ENTRY((unsigned char)text[col], VGA_DEFAULT_ATTR);
+        changed |= shadow_row[col] ^ entry;
+        shadow_row[col] = entry;
+    }
+    if (changed) {
+        vga_dirty_rows |= 1U << row;
+    }
+}
+
+void vga_set_cursor(unsigned int row, unsigned int col) {
+    if (row >= VGA_HEIGHT || col >= VGA_WIDTH) {
+        return;
+    }
+    vga_cursor_row = row;
+    vga_cursor_col = col;
+}
+
+void vga_batch_begin(void) {
+    vga_batch_depth++;
+}
+
+void vga_batch_end(void) {
+    if (vga_batch_depth > 0) {
+        vga_batch_depth--;
+    }
+    if (vga_batch_depth == 0) {
+        vga_flush();
     }
 }
 
+void vga_init(void) {
+    vga_batch_depth = 0;
+    vga_hw_cursor = 0xFFFFFFFF;
+    vga_clear();
+}
+
 // Clear the entire VGA screen and reset cursor
 void vga_clear(void) {
     for (unsigned int row = 0; row < VGA_HEIGHT; row++) {
@@ -59,38 +166,34 @@ void vga_clear(void) {
     }
     vga_cursor_row = 0;
     vga_cursor_col = 0;
+    if (vga_batch_depth == 0) {
+        vga_flush();
+    }
 }
 
 // Write a single character at current cursor position and advance cursor
+// (shadow only; the caller flushes)
 static void vga_putchar(char c) {
-    volatile unsigned short* vga_buffer = vga_get_buffer();
-    
     // Handle newline
     if (c == '\n') {
         // Move to next row, column 0
         vga_cursor_row++;
         vga_cursor_col = 0;
         
-        // If we've scrolled past the bottom, wrap to top (or scroll up)
-        // For simplicity, wrap to top row
+        // Scroll up if we've moved past the bottom
         if (vga_cursor_row >= VGA_HEIGHT) {
-            vga_cursor_row = 0;
+            vga_scroll();
+            vga_cursor_row = VGA_HEIGHT - 1;
         }
         return;
     }
     
-    // Check if we're past screen bounds
-    if (vga_cursor_row >= VGA_HEIGHT) {
-        // Wrap to top row if past bottom
-        vga_cursor_row = 0;
-        vga_cursor_col = 0;
-    }
-    
     // Calculate position in buffer
     unsigned int pos = vga_cursor_row * VGA_WIDTH + vga_cursor_col;
     
     // Write character
-    vga_buffer[pos] = VGA_ENTRY(c, VGA_DEFAULT_ATTR);
+    vga_shadow[pos] = VGA_ENTRY(c, VGA_DEFAULT_ATTR);
+    vga_dirty_rows |= 1U << vga_cursor_row;
     
     // Advance cursor column
     vga_cursor_col++;
@@ -100,19 +203,25 @@ static void vga_putchar(char c) {
         vga_cursor_col = 0;
         vga_cursor_row++;
         
-        // Wrap to top if past bottom
+        // Scroll up if past bottom
         if (vga_cursor_row >= VGA_HEIGHT) {
-            vga_cursor_row = 0;
+            vga_scroll();
+            vga_cursor_row = VGA_HEIGHT - 1;
         }
     }
 }
 
 // Write a null-terminated string using cursor-based output
-// Supports '\n' for newlines
+// Supports '\n' for newlines; flushes once at the end unless batched
 void vga_write(const char* s) {
+    TRACE_BEGIN(TRACE_VGA_WRITE, 0);
     unsigned int i = 0;
     while (s[i] != '\0') {
         vga_putchar(s[i]);
         i++;
     }
+    if (vga_batch_depth == 0) {
+        vga_flush();
+    }
+    TRACE_END(TRACE_VGA_WRITE, 0);
 }
@@ -8,12 +8,35 @@
 #define VGA_WIDTH 80
 #define VGA_HEIGHT 25
 
+// Initialize the RAM shadow buffer and clear the screen
+// Must be called before any other vga_* function
+void vga_init(void);
+
 // Clear the VGA screen and reset cursor to top-left
 void vga_clear(void);
 
 // Write a null-terminated ASCII string to VGA buffer
 // Supports '\n' for newlines - automatically advances to next row
 // Cursor advances on each character and wraps to next line on '\n'
+// Scrolls the screen up one row when output passes the bottom row
+// Output lands in a RAM shadow and is flushed to the device when the
+// write (or the enclosing batch) ends
 void vga_write(const char* s);
 
+// Group several vga_write()/vga_clear() calls into one device flush
+// Batches nest; the shadow is flushed when the outermost batch ends
+void vga_batch_begin(void);
+void vga_batch_end(void);
+
+// Copy dirty shadow rows to VGA memory and update the hardware cursor
+void vga_flush(void);
+
+// Replace one shadow row with VGA_WIDTH characters of text (default attribute)
+// The row is marked dirty only if its contents changed
+// Used by the console compositor; does not flush
+void vga_draw_row(unsigned int row, const char* text);
+
+// Move the cursor (applied to the hardware cursor on the next flush)
+void vga_set_cursor(unsigned int row, unsigned int col);
+
 #endif // VGA_H
@@ -0,0 +1,15 @@
+// AgentOS Sample Agent Module
+// Week 3: Built separately from kernel.elf and loaded by GRUB (module2 in grub.cfg)
+
+// Compiled as a relocatable object with no writable data: the kernel maps
+// it read-only as loaded and links calls into the ring-3 library on the
+// agent's first run, so only user_* functions may be called
+
+#include "user/user.h"
+#include "intent/intent.h"
+
+void agent_main(void* context) {
+    (void)context;
+    
+    user_intent_submit(INTENT_CONSOLE_WRITE, "hello module: loaded by GRUB, relocated in place\n");
+}
@@ -0,0 +1,169 @@
+#!/usr/bin/env python3
+"""Compare AgentOS benchmark results with the checked-in baseline.
+
+Usage:
+    python3 tools/benchcmp.py build/bench/serial.log tools/bench-baseline.txt
+    python3 tools/benchcmp.py --update build/bench/serial.log tools/bench-baseline.txt
+
+`make bench` runs the first form after a headless boot; `make bench-update`
+runs the second, which rewrites the baseline values from the log (keeping
+tolerances and comments).
+
+The kernel (built with `make BENCH=1`) writes:
+    TUNABLE <name> <value>               (configuration of the run)
+    BENCH <metric> <value> <unit>        (lower is better)
+    BENCH <group> skipped (<reason>)     (group: prefix of its metrics)
+    BENCH-INFO <metric> <key>=<value> ...
+    BENCH-END
+
+The baseline has one "<metric> <value> <unit> <tolerance %>" line per metric
+('#' starts a comment). A metric regresses when it exceeds its baseline value
+by more than its tolerance. Exits 1 on a regression, a missing or skipped
+baseline metric, a unit mismatch, a baseline with no metrics (nothing would
+be checked), or a log without BENCH-END (the run hung or crashed); 0
+otherwise.
+"""
+
+import sys
+
+DEFAULT_TOLERANCE = 25
+
+
+def parse_log(lines):
+    results = {}
+    skipped = {}
+    tunables = {}
+    complete = False
+
+    for raw in lines:
+        line = raw.strip()
+        if line == "BENCH-END":
+            complete = True
+            continue
+        parts = line.split()
+        if len(parts) == 3 and parts[0] == "TUNABLE":
+            tunables[parts[1]] = parts[2]
+            continue
+        if len(parts) < 3 or parts[0] != "BENCH":
+            continue
+        if parts[2] == "skipped":
+            skipped[parts[1]] = " ".join(parts[3:]).strip("()")
+            continue
+        if len(parts) == 4 and parts[2].isdigit():
+            results[parts[1]] = (int(parts[2]), parts[3])
+
+    return results, skipped, tunables, complete
+
+
+def load_baseline(path):
+    baseline = {}
+    with open(path, "r") as f:
+        for number, raw in enumerate(f, 1):
+            line = raw.split("#", 1)[0].strip()
+            if not line:
+                continue
+            parts = line.split()
+            if len(parts) != 4:
+                raise SystemExit("%s:%d: expected <metric> <value> <unit> <tolerance %%>" % (path, number))
+            baseline[parts[0]] = (int(parts[1]), parts[2], int(parts[3]))
+    return baseline
+
+
+def compare(results, skipped, baseline):
+    failures = 0
+    print("%-34s %10s %10s %8s  %s" % ("metric", "baseline", "result", "change", "status"))
+
+    for metric, (base, unit, tolerance) in baseline.items():
+        if metric not in results:
+            reason = next(("skipped: " + why for group, why in skipped.items() if metric.startswith(group)),
+                          "not reported")
+            print("%-34s %10d %10s %8s  FAIL (%s)" % (metric, base, "-", "-", reason))
+            failures += 1
+            continue
+        value, result_unit = results[metric]
+        if result_unit != unit:
+            print("%-34s %10d %10d %8s  FAIL (unit %s, baseline %s)" % (metric, base, value, "-", result_unit, unit))
+            failures += 1
+            continue
+
+        change = (value - base) * 100.0 / base if base else 0.0
+        if value > base * (100 + tolerance) / 100.0:
+            status = "REGRESSED (tolerance %d%%)" % tolerance
+            failures += 1
+        elif value < base * (100 - tolerance) / 100.0:
+            status = "improved (consider make bench-update)"
+        else:
+            status = "ok"
+        print("%-34s %10d %10d %+7.1f%%  %s" % (metric, base, value, change, status))
+
+    # Reported but not tracked yet: shown, never a failure
+    for metric, (value, unit) in results.items():
+        if metric not in baseline:
+            print("%-34s %10s %10d %8s  new (%s, not in baseline)" % (metric, "-", value, "-", unit))
+
+    return failures
+
+
+def update_baseline(path, results):
+    with open(path, "r") as f:
+        lines = f.readlines()
+
+    out = []
+    seen = set()
+    for raw in lines:
+        line = raw.split("#", 1)[0].strip()
+        parts = line.split()
+        if len(parts) == 4 and parts[0] in results:
+            value, unit = results[parts[0]]
+            out.append("%s %d %s %s\n" % (parts[0], value, unit, parts[3]))
+            seen.add(parts[0])
+        else:
+            out.append(raw)
+
+    new = [metric for metric in results if metric not in seen]
+    if new and out and out[-1].strip():
+        out.append("\n")
+    for metric in new:
+        value, unit = results[metric]
+        out.append("%s %d %s %d\n" % (metric, value, unit, DEFAULT_TOLERANCE))
+
+    with open(path, "w") as f:
+        f.writelines(out)
+
+
+def main():
+    args = sys.argv[1:]
+    update = len(args) == 3 and args[0] == "--update"
+    if update:
+        args = args[1:]
+    if len(args) != 2:
+        raise SystemExit(__doc__)
+    log_path, baseline_path = args
+
+    with open(log_path, "r", errors="replace") as f:
+        results, skipped, tunables, complete = parse_log(f)
+    if not complete:
+        print("benchcmp: no BENCH-END in %s (run incomplete)" % log_path)
+        return 1
+    if tunables:
+        print("tunables: " + " ".join("%s=%s" % item for item in tunables.items()))
+
+    if update:
+        update_baseline(baseline_path, results)
+        print("benchcmp: %d metrics written to %s" % (len(results), baseline_path))
+        return 0
+
+    baseline = load_baseline(baseline_path)
+    failures = compare(results, skipped, baseline)
+    if not baseline:
+        print("benchcmp: ERROR: %s tracks no metrics, so nothing was checked" % baseline_path)
+        print("benchcmp: record one with `make bench-update` on the machine that runs `make bench`, and commit it")
+        return 1
+    if failures:
+        print("benchcmp: %d metric(s) failed" % failures)
+        return 1
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+"""Fold AgentOS profiler samples into flame-graph input.
+
+Usage:
+    python3 tools/prof2folded.py build/serial.log [build/kernel.elf] > build/prof.folded
+    flamegraph.pl build/prof.folded > build/prof.svg
+
+The kernel (via `make PROFILE=1` or an INTENT_PROFILE_CONTROL "dump") writes:
+    PROF-BEGIN hz=<hex> samples=<hex> dropped=<hex>
+    S <eip> <ret1> <ret2> ...            (hex, innermost frame first)
+    PROF-END
+
+Addresses are symbolized against the kernel ELF with `nm` (set NM to override,
+e.g. NM=llvm-nm). Output is one "root;...;leaf count" line per unique stack.
+"""
+
+import bisect
+import collections
+import os
+import subprocess
+import sys
+
+
+def load_symbols(elf):
+    nm = os.environ.get("NM", "nm")
+    out = subprocess.run([nm, "-n", elf], check=True, capture_output=True, text=True).stdout
+    addrs, names = [], []
+    for line in out.splitlines():
+        parts = line.split()
+        if len(parts) != 3 or parts[1] not in "tTwW":
+            continue
+        addrs.append(int(parts[0], 16))
+        names.append(parts[2])
+    return addrs, names
+
+
+def symbolize(addrs, names, pc):
+    i = bisect.bisect_right(addrs, pc) - 1
+    if i < 0:
+        return "0x%x" % pc
+    return names[i]
+
+
+def parse_samples(lines):
+    samples = []
+    header = None
+    in_prof = False
+    for raw in lines:
+        line = raw.strip()
+        if line.startswith("PROF-BEGIN"):
+            header = dict(f.split("=", 1) for f in line.split()[1:])
+            samples = []
+            in_prof = True
+        elif line.startswith("PROF-END"):
+            in_prof = False
+        elif in_prof and line.startswith("S"):
+            samples.append([int(x, 16) for x in line.split()[1:]])
+    if header is None:
+        raise SystemExit("no PROF-BEGIN marker found")
+    return header, samples
+
+
+def main():
+    if len(sys.argv) not in (2, 3):
+        raise SystemExit(__doc__)
+    elf = sys.argv[2] if len(sys.argv) == 3 else "build/kernel.elf"
+    with open(sys.argv[1], "r", errors="replace") as f:
+        header, samples = parse_samples(f)
+    addrs, names = load_symbols(elf)
+
+    folded = collections.Counter()
+    for pcs in samples:
+        if not pcs:
+            continue
+        # Return addresses point after the call; look up the call instruction instead
+        frames = [symbolize(addrs, names, pcs[0])]
+        frames += [symbolize(addrs, names, pc - 1) for pc in pcs[1:]]
+        folded[";".join(reversed(frames))] += 1
+
+    for stack, count in sorted(folded.items()):
+        print("%s %d" % (stack, count))
+
+    dropped = int(header.get("dropped", "0"), 16)
+    if dropped:
+        print("warning: %d samples dropped (buffer full)" % dropped, file=sys.stderr)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+"""Convert an AgentOS serial trace export into Chrome trace-event JSON.
+
+Usage:
+    python3 tools/trace2chrome.py build/serial.log > build/trace.json
+
+Open the result in chrome://tracing or https://ui.perfetto.dev.
+
+The kernel (built with `make TRACE=1`) writes:
+    TRACE-BEGIN khz=<hex cycles/ms> boot=<hex boot TSC>
+    T <cpu> <tsc> <B|E> <name> <arg>     (numbers in hex)
+    TRACE-END
+"""
+
+import json
+import sys
+
+
+def parse(lines):
+    khz = None
+    boot = 0
+    events = []
+    in_trace = False
+
+    for raw in lines:
+        line = raw.strip()
+        if line.startswith("TRACE-BEGIN"):
+            fields = dict(f.split("=", 1) for f in line.split()[1:])
+            khz = int(fields["khz"], 16)
+            boot = int(fields["boot"], 16)
+            events = []
+            in_trace = True
+            continue
+        if line.startswith("TRACE-END"):
+            in_trace = False
+            continue
+        if not in_trace or not line.startswith("T "):
+            continue
+
+        parts = line.split()
+        if len(parts) != 6:
+            continue
+        _, cpu, tsc, phase, name, arg = parts
+        cycles = int(tsc, 16) - boot
+        arg_value = int(arg, 16)
+        if arg_value >= 0x80000000:
+            arg_value -= 0x100000000
+        events.append({
+            "name": name,
+            "ph": phase,
+            # Chrome trace timestamps are microseconds
+            "ts": cycles * 1000.0 / khz,
+            "pid": 0,
+            "tid": int(cpu, 16),
+            "args": {"arg": arg_value},
+        })
+
+    if khz is None:
+        raise SystemExit("no TRACE-BEGIN marker found")
+    return events
+
+
+def main():
+    if len(sys.argv) != 2:
+        raise SystemExit(__doc__)
+    with open(sys.argv[1], "r", errors="replace") as f:
+        events = parse(f)
+    json.dump({"traceEvents": events, "displayTimeUnit": "ns"}, sys.stdout)
+    sys.stdout.write("\n")
+
+
+if __name__ == "__main__":
+    main()